@@ -0,0 +1,54 @@
+// jshint esversion: 8
+
+// Cost per call of seeder.fastRandom(prng), prng.random() and the builtin
+// Math.random(), best of a few rounds each.
+//
+//     $ npm run bench
+
+var seeder = require('../pkg/seeder');
+
+const builtin = Math.random;
+const calls = 10000000;
+const rounds = 5;
+
+function ns(total) {
+  return (Number(total) / calls).toFixed(2) + "ns";
+}
+
+// Sums the draws, so that the calls can't be optimized away.
+function run(random) {
+  let best = Infinity;
+  let sum = 0;
+
+  for (let r = 0; r < rounds; r++) {
+    const start = process.hrtime.bigint();
+    for (let i = 0; i < calls; i++) {
+      sum += random();
+    }
+    best = Math.min(best, Number(process.hrtime.bigint() - start));
+  }
+
+  if (!(sum > 0)) {
+    throw new Error('no draws');
+  }
+  return best;
+}
+
+function main() {
+  const prng = new seeder.PRNG();
+  const native = new seeder.PRNG();
+
+  const cases = [
+    ['Math.random() (builtin)', builtin],
+    ['fastRandom(prng)', seeder.fastRandom(prng)],
+    ['prng.random()', () => native.random()],
+  ];
+
+  const base = run(builtin);
+  for (const [name, random] of cases) {
+    const best = random === builtin ? base : run(random);
+    console.log(`${name}: ${ns(best)} per call, ${(best / base).toFixed(2)}x builtin`);
+  }
+}
+
+main();
@@ -0,0 +1,54 @@
+// jshint esversion: 8
+
+// Latency of seeder.reseed() and of the eager threadpool pass on top of it.
+//
+//     $ UV_THREADPOOL_SIZE=16 npm run bench
+
+var seeder = require('../pkg/seeder');
+var crypto = require('node:crypto');
+var util = require('util');
+
+const reseedThreadpool = util.promisify(seeder.reseedThreadpool);
+const poolSize = Number(process.env.UV_THREADPOOL_SIZE || 4);
+
+function median(values) {
+  const sorted = Array.from(values).sort((a, b) => a - b);
+  return sorted[sorted.length >> 1];
+}
+
+function us(ns) {
+  return (Number(ns) / 1000).toFixed(1) + "us";
+}
+
+async function main() {
+  // Start every threadpool thread and its DRBGs.
+  await Promise.all(Array.from({ length: poolSize * 2 },
+                               () => util.promisify(crypto.randomBytes)(16)));
+
+  const rounds = 200;
+
+  let start = process.hrtime.bigint();
+  for (let i = 0; i < rounds; i++) {
+    seeder.reseed();
+  }
+  console.log(`reseed(): ${us((process.hrtime.bigint() - start) / BigInt(rounds))} per call`);
+
+  for (let threads = 1; threads <= poolSize; threads *= 2) {
+    const latencies = [];
+    let reached = 0;
+
+    start = process.hrtime.bigint();
+    for (let i = 0; i < rounds; i++) {
+      const stats = await reseedThreadpool(threads);
+      latencies.push(...stats.latencies);
+      reached += stats.threads;
+    }
+    const total = (process.hrtime.bigint() - start) / BigInt(rounds);
+
+    console.log(`reseedThreadpool(${threads}): ${us(total)} per call, ` +
+                `${us(median(latencies))} median per thread, ` +
+                `${(reached / rounds).toFixed(1)} threads reached`);
+  }
+}
+
+main();
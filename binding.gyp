@@ -1,19 +1,54 @@
 {
+  "variables": {
+    # static_library or shared_library, the latter lets several addons of one
+    # process share the reseed registry.
+    "nreseed_library%": "static_library"
+  },
   "targets": [
+    {
+      "target_name": "libnreseed",
+      "type": "<(nreseed_library)",
+      "cflags!": [ "-fno-exceptions" ],
+      "cflags_cc!": [ "-fno-exceptions" ],
+      "cflags": [ "-fPIC" ],
+      "sources": [
+        "src/nreseed.cc",
+        "src/utils/time.cc",
+        "src/utils/random-number-generator.cc"
+      ],
+      "direct_dependent_settings": {
+        "include_dirs": [ "src" ]
+      }
+    },
     {
       "target_name": "nreseed",
+      "dependencies": [ "libnreseed" ],
       "cflags!": [ "-fno-exceptions" ],
       "cflags_cc!": [ "-fno-exceptions" ],
       "sources": [
         "src/seeder.cc",
         "src/prng.cc",
-        "src/utils/time.cc",
-        "src/utils/random-number-generator.cc"
+        "src/replay_log.cc",
+        "src/weighted_sampler.cc",
+        "src/reservoir.cc",
+        "src/prng_pool.cc",
+        "src/threadpool_reseed.cc",
+        "src/permutation.cc",
+        "src/quasi_random.cc",
+        "src/random_stream.cc",
+        "src/discrete.cc",
+        "src/bernoulli.cc",
+        "src/shared_streams.cc"
       ],
       "include_dirs": [
         "<!@(node -p \"require('node-addon-api').include\")"
       ],
-      'defines': [ 'NAPI_DISABLE_CPP_EXCEPTIONS' ],
+      "conditions": [
+        # shm_open() of SharedStreams, in libc itself since glibc 2.34.
+        [ 'OS=="linux"', { "libraries": [ "-lrt" ] } ]
+      ],
+      # NAPI_VERSION 8 for object type tags.
+      'defines': [ 'NAPI_DISABLE_CPP_EXCEPTIONS', 'NAPI_VERSION=8' ],
     }
   ]
 }
@@ -1,15 +1,209 @@
 // jshint esversion: 6
 
-var addon = require('bindings')('nreseed');
+var stream = require('stream');
+var v8 = require('v8');
 
-module.exports.PRNG = addon.PRNG;
-module.exports.internal = addon;
+// Node can not put native addons into user-land startup snapshots, so while
+// a snapshot is being built (node --build-snapshot) the addon is left alone
+// and loaded on first use in the processes started from it.
+var snapshot = v8.startupSnapshot;
+var addon = null;
+
+function isBuildingSnapshot() {
+  return !!(snapshot && snapshot.isBuildingSnapshot());
+}
+
+function load() {
+  if (addon === null) {
+    if (isBuildingSnapshot()) {
+      throw new Error('nreseed can not be used while building a startup snapshot');
+    }
+    addon = require('bindings')('nreseed');
+  }
+  return addon;
+}
+
+if (!isBuildingSnapshot()) {
+  load();
+}
+
+['PRNG', 'WeightedSampler', 'Reservoir', 'PRNGPool', 'Permutation', 'Sobol',
+ 'Halton', 'Poisson', 'Binomial', 'Geometric', 'BernoulliSampler',
+ 'SharedStreams'].forEach(function(name) {
+  Object.defineProperty(module.exports, name, {
+    enumerable: true,
+    get: function() {
+      return load()[name];
+    }
+  });
+});
+
+Object.defineProperty(module.exports, 'internal', { enumerable: true, get: load });
+
+module.exports.reseedOnFork = function() {
+  return load().reseedOnFork.apply(null, arguments);
+};
+
+module.exports.reseedThreadpool = function() {
+  return load().reseedThreadpool.apply(null, arguments);
+};
 
 module.exports.reseed = function() {
-  addon.reseed();
+  if (isBuildingSnapshot()) {
+    // Reseeding now would put the same state into every process started
+    // from the snapshot. The builtin keeps serving the build, the first call
+    // after deserialization reseeds.
+    var builtin = Math.random;
+    Math.random = function random() {
+      if (isBuildingSnapshot()) {
+        return builtin();
+      }
+      module.exports.reseed();
+      return Math.random();
+    };
+    return;
+  }
+
+  load().reseed();
 
   var prng = new addon.PRNG();
   Math.random = function() {
     return prng.random();
   };
 };
+
+// Returns Math.random() compatible function that runs xorshift128+ of |prng|
+// in JS over its shared state (see PRNG.sharedState()), bit-exact with
+// prng.random() and V8's RandomNumberGenerator. Seeding stays native: reseed
+// requests (seeder.reseed(), from any thread) and forks only move a counter,
+// and the next step goes through prng.random(), which reseeds on this thread.
+module.exports.fastRandom = function(prng) {
+  var s = prng.sharedState();
+  var forks = load().forkGeneration;
+
+  // Not a valid count, so the first step syncs with the native side.
+  var reseeds = -1;
+  var fork = -1;
+
+  return function random() {
+    if (s[4] !== reseeds || forks[0] !== fork) {
+      reseeds = s[4];
+      fork = forks[0];
+      return prng.random();
+    }
+
+    // state0, state1 = state1, xorshift(state0, state1) on uint32 halves.
+    var s1lo = s[0], s1hi = s[1];
+    var s0lo = s[2], s0hi = s[3];
+
+    s1hi ^= (s1hi << 23) | (s1lo >>> 9);
+    s1lo ^= s1lo << 23;
+    s1lo ^= (s1lo >>> 17) | (s1hi << 15);
+    s1hi ^= s1hi >>> 17;
+    s1lo ^= s0lo ^ ((s0lo >>> 26) | (s0hi << 6));
+    s1hi ^= s0hi ^ (s0hi >>> 26);
+
+    s[0] = s0lo;
+    s[1] = s0hi;
+    s[2] = s1lo;
+    s[3] = s1hi;
+
+    // ToDouble(state0): upper 52 bits over 2^52.
+    return (s0hi * 1048576 + (s0lo >>> 12)) / 4503599627370496;
+  };
+};
+
+// Returns function that decides with the probability of |sampler| (a
+// BernoulliSampler) and keeps the countdown to the next success in JS, so
+// only successes cross into native code.
+module.exports.fastBernoulli = function(sampler) {
+  var left = sampler.gap();
+
+  return function bernoulli() {
+    if (left > 0) {
+      left--;
+      return false;
+    }
+
+    left = sampler.gap();
+    return true;
+  };
+};
+
+// Returns Readable stream of random bytes in chunkSize (1MB) external Buffers
+// filled on the threadpool, either by OpenSSL (secure) or by a generator
+// seeded from prng (left alone with secure). Chunk memory is recycled once the
+// Buffers are collected.
+// With prefill (default) one chunk is generated ahead of demand. The stream
+// ends after length bytes, if given.
+module.exports.createRandomStream = function(options) {
+  options = options || {};
+
+  var secure = !!options.secure;
+  var source = new (load().ByteSource)(options.chunkSize || 1 << 20,
+                                    secure ? undefined : options.prng, secure);
+  var prefill = options.prefill !== false;
+  var remaining = options.length === undefined ? Infinity : options.length;
+
+  var ready = [];
+  var reading = false;
+  var wanted = false;
+
+  var readable = new stream.Readable({
+    read: function() {
+      if (ready.length) {
+        deliver();
+        return;
+      }
+
+      wanted = true;
+      if (!reading) {
+        fetch();
+      }
+    }
+  });
+
+  function fetch() {
+    reading = true;
+    source.read(function(err, chunk) {
+      reading = false;
+      if (readable.destroyed) {
+        return;
+      }
+      if (err) {
+        readable.destroy(err);
+        return;
+      }
+
+      ready.push(chunk);
+      if (wanted) {
+        wanted = false;
+        deliver();
+      }
+    });
+  }
+
+  function deliver() {
+    var chunk = ready.shift();
+    if (chunk.length > remaining) {
+      chunk = chunk.subarray(0, remaining);
+    }
+    remaining -= chunk.length;
+
+    readable.push(chunk);
+    if (remaining === 0) {
+      readable.push(null);
+      return;
+    }
+
+    if (prefill && !reading) {
+      fetch();
+    }
+  }
+
+  if (remaining === 0) {
+    readable.push(null);
+  }
+
+  return readable;
+};
@@ -0,0 +1,99 @@
+#include "bernoulli.h"
+
+#include <cstring>
+#include <limits>
+
+Napi::Object BernoulliSampler::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func =
+      DefineClass(env,
+                  "BernoulliSampler", {
+                  InstanceMethod("sample",   &BernoulliSampler::Sample),
+                  InstanceMethod("gap",      &BernoulliSampler::Gap),
+                  InstanceMethod("fillMask", &BernoulliSampler::FillMask)});
+
+  exports.Set("BernoulliSampler", func);
+
+  return exports;
+}
+
+BernoulliSampler::BernoulliSampler(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<BernoulliSampler>(info) {
+  Napi::Env env = info.Env();
+
+  if (!info.Length() || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+    return;
+  }
+
+  const double p = info[0].As<Napi::Number>().DoubleValue();
+  if (!(p >= 0 && p <= 1)) {
+    Napi::RangeError::New(env, "Probability out of range").ThrowAsJavaScriptException();
+    return;
+  }
+
+  if (!this->source_.Init(env, info[1])) {
+    return;
+  }
+
+  this->p_ = p;
+  if (p > 0) {
+    this->geometric_.Init(&p);
+  }
+
+  this->left_ = NextGap();
+}
+
+double BernoulliSampler::NextGap() {
+  if (this->p_ == 0) {
+    return std::numeric_limits<double>::infinity();
+  }
+
+  return this->geometric_.Sample(this->source_.rng()) - 1;
+}
+
+Napi::Value BernoulliSampler::Sample(const Napi::CallbackInfo& info) {
+  if (this->left_ > 0) {
+    this->left_--;
+    return Napi::Boolean::New(info.Env(), false);
+  }
+
+  this->left_ = NextGap();
+  return Napi::Boolean::New(info.Env(), true);
+}
+
+// Draws a fresh gap (the number of failures before a success) for callers that
+// count down on their own, independent of sample() and fillMask().
+Napi::Value BernoulliSampler::Gap(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), NextGap());
+}
+
+// fillMask(out) sets out[i] to 1 for successes and 0 otherwise, continuing the
+// sequence of sample(), and returns the number of successes. The cost is one
+// memset plus one draw per success.
+Napi::Value BernoulliSampler::FillMask(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!info.Length() || !info[0].IsTypedArray() ||
+      info[0].As<Napi::TypedArray>().TypedArrayType() != napi_uint8_array) {
+    Napi::TypeError::New(env, "Uint8Array expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Uint8Array out = info[0].As<Napi::Uint8Array>();
+  uint8_t* data = out.Data();
+  const size_t length = out.ElementLength();
+
+  memset(data, 0, length);
+
+  double position = this->left_;
+  size_t successes = 0;
+  while (position < length) {
+    data[static_cast<size_t>(position)] = 1;
+    successes++;
+    position += 1 + NextGap();
+  }
+
+  this->left_ = position - length;
+
+  return Napi::Number::New(env, static_cast<double>(successes));
+}
@@ -0,0 +1,35 @@
+#ifndef BERNOULLI_H
+#define BERNOULLI_H
+
+#include <napi.h>
+
+#include "discrete.h"
+#include "prng.h"
+
+// Object that makes independent yes/no decisions with probability p. Instead
+// of one uniform per decision it draws the gap to the next success from the
+// geometric distribution, so with small p almost every decision is a counter
+// decrement.
+class BernoulliSampler : public Napi::ObjectWrap<BernoulliSampler> {
+ public:
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+  BernoulliSampler(const Napi::CallbackInfo& info);
+
+ private:
+  Napi::Value Sample(const Napi::CallbackInfo& info);
+  Napi::Value Gap(const Napi::CallbackInfo& info);
+  Napi::Value FillMask(const Napi::CallbackInfo& info);
+
+  // Number of failures before the next success, infinite for p = 0.
+  double NextGap();
+
+  RandomSource source_;
+  GeometricDistribution geometric_;
+  double p_ = 0;
+
+  // Failures left before the next success of sample() and fillMask().
+  double left_ = 0;
+};
+
+#endif
@@ -0,0 +1,321 @@
+#include "discrete.h"
+
+#include <algorithm>
+
+namespace {
+
+// Largest parameter that is still an exact integer in a double.
+constexpr double kMaxSafeInteger = 9007199254740992.0;
+
+}  // namespace
+
+const char* PoissonDistribution::Init(const double* parameters) {
+  const double lambda = parameters[0];
+  if (!(lambda >= 0 && lambda <= kMaxSafeInteger)) {
+    return "Mean out of range";
+  }
+
+  lambda_ = lambda;
+  exp_lambda_ = std::exp(-lambda);
+
+  log_lambda_ = std::log(lambda);
+  b_ = 0.931 + 2.53 * std::sqrt(lambda);
+  a_ = -0.059 + 0.02483 * b_;
+  log_alpha_ = std::log(1.1239 + 1.1328 / (b_ - 3.4));
+  vr_ = 0.9277 - 3.6224 / (b_ - 2);
+
+  return nullptr;
+}
+
+double PoissonDistribution::Sample(v8::base::RandomNumberGenerator& rng) const {
+  return lambda_ < 10 ? SampleInversion(rng) : SamplePTRS(rng);
+}
+
+double PoissonDistribution::SampleInversion(v8::base::RandomNumberGenerator& rng) const {
+  for (;;) {
+    const double u = rng.NextDouble();
+    double p = exp_lambda_;
+    double sum = p;
+
+    // The tail beyond 100 is below 1e-50 for lambda < 10, but rounding may
+    // keep the sum below u forever, so give up there and draw again.
+    for (int k = 0; k < 100; k++) {
+      if (u < sum) {
+        return k;
+      }
+      p *= lambda_ / (k + 1);
+      sum += p;
+    }
+  }
+}
+
+double PoissonDistribution::SamplePTRS(v8::base::RandomNumberGenerator& rng) const {
+  for (;;) {
+    const double u = rng.NextDouble() - 0.5;
+    const double v = rng.NextDouble();
+    const double us = 0.5 - std::fabs(u);
+    const double k = std::floor((2 * a_ / us + b_) * u + lambda_ + 0.43);
+
+    if (us >= 0.07 && v <= vr_) {
+      return k;
+    }
+
+    if (k < 0 || (us < 0.013 && v > us)) {
+      continue;
+    }
+
+    if (std::log(v) + log_alpha_ - std::log(a_ / (us * us) + b_) <=
+        -lambda_ + k * log_lambda_ - std::lgamma(k + 1)) {
+      return k;
+    }
+  }
+}
+
+const char* BinomialDistribution::Init(const double* parameters) {
+  const double n = parameters[0];
+  const double p = parameters[1];
+
+  if (!(n >= 0 && n <= kMaxSafeInteger) || n != std::floor(n)) {
+    return "Number of trials must be an integer in [0, 2^53]";
+  }
+  if (!(p >= 0 && p <= 1)) {
+    return "Probability out of range";
+  }
+
+  n_ = n;
+  flipped_ = p > 0.5;
+  r_ = flipped_ ? 1 - p : p;
+  q_ = 1 - r_;
+
+  const double np = n * r_;
+
+  qn_ = std::exp(n * std::log1p(-r_));
+  bound_ = std::min(n, np + 10 * std::sqrt(np * q_ + 1));
+
+  const double fm = np + r_;
+  m_ = std::floor(fm);
+  p1_ = std::floor(2.195 * std::sqrt(np * q_) - 4.6 * q_) + 0.5;
+  xm_ = m_ + 0.5;
+  xl_ = xm_ - p1_;
+  xr_ = xm_ + p1_;
+  c_ = 0.134 + 20.5 / (15.3 + m_);
+
+  double a = (fm - xl_) / (fm - xl_ * r_);
+  laml_ = a * (1 + a / 2);
+  a = (xr_ - fm) / (xr_ * q_);
+  lamr_ = a * (1 + a / 2);
+
+  p2_ = p1_ * (1 + 2 * c_);
+  p3_ = p2_ + c_ / laml_;
+  p4_ = p3_ + c_ / lamr_;
+
+  return nullptr;
+}
+
+double BinomialDistribution::Sample(v8::base::RandomNumberGenerator& rng) const {
+  if (r_ == 0) {
+    return flipped_ ? n_ : 0;
+  }
+
+  const double y = n_ * r_ < 30 ? SampleInversion(rng) : SampleBTPE(rng);
+  return flipped_ ? n_ - y : y;
+}
+
+double BinomialDistribution::SampleInversion(v8::base::RandomNumberGenerator& rng) const {
+  double x = 0;
+  double px = qn_;
+  double u = rng.NextDouble();
+
+  while (u > px) {
+    x++;
+    if (x > bound_) {
+      x = 0;
+      px = qn_;
+      u = rng.NextDouble();
+    } else {
+      u -= px;
+      px = ((n_ - x + 1) * r_ * px) / (x * q_);
+    }
+  }
+
+  return x;
+}
+
+// Steps follow the paper: a triangular region, two parallelograms and two
+// exponential tails, then acceptance by explicit evaluation of f(y) / f(m)
+// close to the mode and by squeeze and Stirling's formula further out.
+double BinomialDistribution::SampleBTPE(v8::base::RandomNumberGenerator& rng) const {
+  const double n = n_;
+  const double r = r_;
+  const double q = q_;
+  const double m = m_;
+  const double nrq = n * r * q;
+
+  for (;;) {
+    const double u = rng.NextDouble() * p4_;
+    double v = rng.NextDouble();
+    double y;
+
+    if (u <= p1_) {
+      // Triangle, accepted right away.
+      return std::floor(xm_ - p1_ * v + u);
+    }
+
+    if (u <= p2_) {
+      // Parallelograms.
+      const double x = xl_ + (u - p1_) / c_;
+      v = v * c_ + 1 - std::fabs(m - x + 0.5) / p1_;
+      if (v > 1) {
+        continue;
+      }
+      y = std::floor(x);
+    } else if (u <= p3_) {
+      // Left tail.
+      y = std::floor(xl_ + std::log(v) / laml_);
+      if (y < 0 || v == 0) {
+        continue;
+      }
+      v = v * (u - p2_) * laml_;
+    } else {
+      // Right tail.
+      y = std::floor(xr_ - std::log(v) / lamr_);
+      if (y > n || v == 0) {
+        continue;
+      }
+      v = v * (u - p3_) * lamr_;
+    }
+
+    const double k = std::fabs(y - m);
+    if (k <= 20 || k >= nrq / 2 - 1) {
+      // Recursive evaluation of f(y) / f(m).
+      const double s = r / q;
+      const double a = s * (n + 1);
+      double f = 1;
+      if (m < y) {
+        for (double i = m + 1; i <= y; i++) {
+          f *= a / i - s;
+        }
+      } else if (m > y) {
+        for (double i = y + 1; i <= m; i++) {
+          f /= a / i - s;
+        }
+      }
+      if (v <= f) {
+        return y;
+      }
+      continue;
+    }
+
+    // Squeeze on log(f(y) / f(m)).
+    const double rho = (k / nrq) * ((k * (k / 3 + 0.625) + 0.1666666666666) / nrq + 0.5);
+    const double t = -k * k / (2 * nrq);
+    const double log_v = std::log(v);
+    if (log_v < t - rho) {
+      return y;
+    }
+    if (log_v > t + rho) {
+      continue;
+    }
+
+    // Final test with Stirling's formula.
+    const double x1 = y + 1;
+    const double f1 = m + 1;
+    const double z = n + 1 - m;
+    const double w = n - y + 1;
+    const double x2 = x1 * x1;
+    const double f2 = f1 * f1;
+    const double z2 = z * z;
+    const double w2 = w * w;
+
+    const double bound =
+        xm_ * std::log(f1 / x1) + (n - m + 0.5) * std::log(z / w) +
+        (y - m) * std::log(w * r / (x1 * q)) +
+        (13860 - (462 - (132 - (99 - 140 / f2) / f2) / f2) / f2) / f1 / 166320 +
+        (13860 - (462 - (132 - (99 - 140 / z2) / z2) / z2) / z2) / z / 166320 +
+        (13860 - (462 - (132 - (99 - 140 / x2) / x2) / x2) / x2) / x1 / 166320 +
+        (13860 - (462 - (132 - (99 - 140 / w2) / w2) / w2) / w2) / w / 166320;
+
+    if (log_v <= bound) {
+      return y;
+    }
+  }
+}
+
+const char* GeometricDistribution::Init(const double* parameters) {
+  const double p = parameters[0];
+  if (!(p > 0 && p <= 1)) {
+    return "Probability out of range";
+  }
+
+  inv_log_q_ = p == 1 ? 0 : 1 / std::log1p(-p);
+
+  return nullptr;
+}
+
+template <typename Distribution>
+Napi::Object DiscreteSampler<Distribution>::Init(Napi::Env env, Napi::Object exports) {
+  using Wrap = Napi::ObjectWrap<DiscreteSampler<Distribution>>;
+
+  Napi::Function func =
+      Wrap::DefineClass(env,
+                        Distribution::kName, {
+                        Wrap::InstanceMethod("sample", &DiscreteSampler::Sample),
+                        Wrap::InstanceMethod("fill",   &DiscreteSampler::Fill)});
+
+  exports.Set(Distribution::kName, func);
+
+  return exports;
+}
+
+template <typename Distribution>
+DiscreteSampler<Distribution>::DiscreteSampler(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<DiscreteSampler<Distribution>>(info) {
+  Napi::Env env = info.Env();
+
+  double parameters[Distribution::kParameters];
+  for (int i = 0; i < Distribution::kParameters; i++) {
+    if (info.Length() <= static_cast<size_t>(i) || !info[i].IsNumber()) {
+      Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+      return;
+    }
+    parameters[i] = info[i].As<Napi::Number>().DoubleValue();
+  }
+
+  if (const char* error = this->distribution_.Init(parameters)) {
+    Napi::RangeError::New(env, error).ThrowAsJavaScriptException();
+    return;
+  }
+
+  this->source_.Init(env, info[Distribution::kParameters]);
+}
+
+template <typename Distribution>
+Napi::Value DiscreteSampler<Distribution>::Sample(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), this->distribution_.Sample(this->source_.rng()));
+}
+
+template <typename Distribution>
+Napi::Value DiscreteSampler<Distribution>::Fill(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!info.Length() || !info[0].IsTypedArray() ||
+      info[0].As<Napi::TypedArray>().TypedArrayType() != napi_float64_array) {
+    Napi::TypeError::New(env, "Float64Array expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Float64Array out = info[0].As<Napi::Float64Array>();
+  double* data = out.Data();
+  const size_t length = out.ElementLength();
+
+  v8::base::RandomNumberGenerator& rng = this->source_.rng();
+  for (size_t i = 0; i < length; i++) {
+    data[i] = this->distribution_.Sample(rng);
+  }
+
+  return out;
+}
+
+template class DiscreteSampler<PoissonDistribution>;
+template class DiscreteSampler<BinomialDistribution>;
+template class DiscreteSampler<GeometricDistribution>;
@@ -0,0 +1,117 @@
+#ifndef DISCRETE_H
+#define DISCRETE_H
+
+#include <napi.h>
+
+#include <cmath>
+#include <cstdint>
+
+#include "prng.h"
+
+// Poisson distribution. Small means use inversion by sequential search,
+// means of 10 and above Hörmann's PTRS (transformed rejection with squeeze),
+// "The transformed rejection method for generating Poisson random variables",
+// 1993, with constant expected cost.
+class PoissonDistribution {
+ public:
+  static constexpr const char* kName = "Poisson";
+  static constexpr int kParameters = 1;
+
+  // Returns an error message if the parameters are out of range.
+  const char* Init(const double* parameters);
+
+  double Sample(v8::base::RandomNumberGenerator& rng) const;
+
+ private:
+  double SampleInversion(v8::base::RandomNumberGenerator& rng) const;
+  double SamplePTRS(v8::base::RandomNumberGenerator& rng) const;
+
+  double lambda_ = 0;
+
+  // Inversion: exp(-lambda).
+  double exp_lambda_ = 1;
+
+  // PTRS.
+  double log_lambda_ = 0;
+  double a_ = 0;
+  double b_ = 0;
+  double log_alpha_ = 0;
+  double vr_ = 0;
+};
+
+// Binomial distribution. Small means (n * min(p, 1 - p) < 30) use inversion,
+// larger ones Kachitvichyanukul and Schmeiser's BTPE, "Binomial random variate
+// generation", 1988, with constant expected cost.
+class BinomialDistribution {
+ public:
+  static constexpr const char* kName = "Binomial";
+  static constexpr int kParameters = 2;
+
+  const char* Init(const double* parameters);
+
+  double Sample(v8::base::RandomNumberGenerator& rng) const;
+
+ private:
+  double SampleInversion(v8::base::RandomNumberGenerator& rng) const;
+  double SampleBTPE(v8::base::RandomNumberGenerator& rng) const;
+
+  double n_ = 0;
+  // Sampling is done for r = min(p, 1 - p), flipped is r != p.
+  double r_ = 0;
+  double q_ = 1;
+  bool flipped_ = false;
+
+  // Inversion.
+  double qn_ = 1;
+  double bound_ = 0;
+
+  // BTPE.
+  double m_ = 0;
+  double p1_ = 0, p2_ = 0, p3_ = 0, p4_ = 0;
+  double xm_ = 0, xl_ = 0, xr_ = 0;
+  double c_ = 0;
+  double laml_ = 0, lamr_ = 0;
+};
+
+// Geometric distribution: the number of trials up to and including the first
+// success, so values start at 1. Inversion through a single logarithm.
+class GeometricDistribution {
+ public:
+  static constexpr const char* kName = "Geometric";
+  static constexpr int kParameters = 1;
+
+  const char* Init(const double* parameters);
+
+  double Sample(v8::base::RandomNumberGenerator& rng) const {
+    // 1 - u is in (0, 1], its logarithm is 0 (and the result 1) only for u = 0.
+    const double k = std::ceil(std::log(1 - rng.NextDouble()) * inv_log_q_);
+    return k < 1 ? 1 : k;
+  }
+
+ private:
+  // 1 / log(1 - p), 0 for p = 1.
+  double inv_log_q_ = 0;
+};
+
+// Object that draws from a distribution with parameters fixed at construction:
+// new Poisson(lambda[, prng]), new Binomial(n, p[, prng]), new Geometric(p[, prng]).
+template <typename Distribution>
+class DiscreteSampler : public Napi::ObjectWrap<DiscreteSampler<Distribution>> {
+ public:
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+  DiscreteSampler(const Napi::CallbackInfo& info);
+
+ private:
+  Napi::Value Sample(const Napi::CallbackInfo& info);
+  Napi::Value Fill(const Napi::CallbackInfo& info);
+
+  RandomSource source_;
+  Distribution distribution_;
+};
+
+using Poisson = DiscreteSampler<PoissonDistribution>;
+using Binomial = DiscreteSampler<BinomialDistribution>;
+using Geometric = DiscreteSampler<GeometricDistribution>;
+
+#endif
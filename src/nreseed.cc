@@ -0,0 +1,267 @@
+#include "nreseed.h"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include <pthread.h>
+
+#include <openssl/rand.h>
+
+#include "utils/random-number-generator.h"
+#include "utils/time.h"
+#include "utils/bit_cast.h"
+#include "utils/macros.h"
+
+struct nreseed_rng {
+  v8::base::RandomNumberGenerator value;
+};
+
+namespace {
+
+using Hook = std::pair<nreseed_hook, void*>;
+
+std::recursive_mutex registry_mutex;
+std::vector<Hook> registry;
+
+// Forks seen by the child handler, and the count at the last full reseed.
+// The former only changes in a child that has a single thread, so plain reads
+// are fine anywhere.
+volatile uint32_t fork_generation = 0;
+std::atomic<uint32_t> reseeded_generation(0);
+
+void ReseedRNG(void* data) {
+  static_cast<nreseed_rng*>(data)->value.Reseed();
+}
+
+// Keeps the registry consistent across fork(2): no other thread can hold the
+// lock in the child.
+//
+// The child only counts the fork: most children (child_process) exec right
+// away, and the handler runs in the middle of fork(2), where even malloc()
+// may not be safe. nreseed_check_fork() does the work on the next use. That
+// only moves the work, it still takes OpenSSL DRBG locks, which a thread of
+// the parent may have held at fork time (see nreseed.h).
+void AtForkPrepare() { registry_mutex.lock(); }
+void AtForkParent() { registry_mutex.unlock(); }
+void AtForkChild() {
+  // The child thread has a new tid, so it does not own the recursive mutex
+  // anymore and unlock() would fail: start over with a fresh one.
+  new (&registry_mutex) std::recursive_mutex();
+  fork_generation = fork_generation + 1;
+}
+
+}  // namespace
+
+// Outside of node.js there is nobody to provide these for utils/macros.h.
+#ifdef NRESEED_STANDALONE
+#include <cstdio>
+#include <cstdlib>
+
+namespace node {
+
+[[noreturn]] void Abort() {
+  abort();
+}
+
+[[noreturn]] void Assert(const AssertionInfo& info) {
+  fprintf(stderr, "%s: %s: Assertion `%s' failed.\n",
+          info.file_line, info.function, info.message);
+  Abort();
+}
+
+}  // namespace node
+#endif
+
+extern "C" {
+
+nreseed_rng* nreseed_rng_create(void) {
+  nreseed_rng* rng = new (std::nothrow) nreseed_rng();
+  if (rng == nullptr) {
+    return nullptr;
+  }
+
+  rng->value.Reseed();
+
+  if (nreseed_add_hook(ReseedRNG, rng) != NRESEED_OK) {
+    delete rng;
+    return nullptr;
+  }
+
+  return rng;
+}
+
+nreseed_rng* nreseed_rng_create_seeded(int64_t seed) {
+  nreseed_rng* rng = new (std::nothrow) nreseed_rng();
+  if (rng != nullptr) {
+    rng->value.SetSeed(seed);
+  }
+
+  return rng;
+}
+
+void nreseed_rng_destroy(nreseed_rng* rng) {
+  if (rng == nullptr) {
+    return;
+  }
+
+  nreseed_remove_hook(ReseedRNG, rng);
+  delete rng;
+}
+
+void nreseed_rng_seed(nreseed_rng* rng, int64_t seed) {
+  rng->value.SetSeed(seed);
+}
+
+void nreseed_rng_reseed(nreseed_rng* rng) {
+  rng->value.Reseed();
+}
+
+double nreseed_rng_next_double(nreseed_rng* rng) {
+  nreseed_check_fork();
+  return rng->value.NextDouble();
+}
+
+void nreseed_rng_fill_double(nreseed_rng* rng, double* out, size_t n) {
+  nreseed_check_fork();
+  for (size_t i = 0; i < n; i++) {
+    out[i] = rng->value.NextDouble();
+  }
+}
+
+void nreseed_rng_fill_bytes(nreseed_rng* rng, void* out, size_t n) {
+  nreseed_check_fork();
+  rng->value.FillBytes(out, n);
+}
+
+uint32_t nreseed_rng_next_bits(nreseed_rng* rng, int n) {
+  nreseed_check_fork();
+  return rng->value.NextBits(n);
+}
+
+void nreseed_rng_set_v8_compatible(nreseed_rng* rng, int v8_compatible) {
+  rng->value.set_v8_compatible(v8_compatible != 0);
+}
+
+namespace {
+
+int64_t AdditionalInput() {
+  int64_t addin = v8::base::NowFromSystemTime() << 24;
+  addin ^= v8::base::TimeTicksNow();
+  return addin;
+}
+
+// We don't have any entropy data here, so kindly ask OpenSSL impl to get
+// us some. We could perform RAND_seed(getpid()) as it is advertised in
+// Random_fork-satefy, but in PID namespaces all processes will be having
+// the same pid_t with very high probability (around pid_t == 1).
+int ReseedDRBG(EVP_RAND_CTX* drbg) {
+  if (drbg == NULL) {
+    return NRESEED_ENODRBG;
+  }
+
+  auto addin_buf = v8::base::bit_cast<std::array<unsigned char, 8>>(AdditionalInput());
+  if (!EVP_RAND_reseed(drbg, 0, NULL, 0, addin_buf.data(), 8)) {
+    return NRESEED_ERESEED;
+  }
+
+  return NRESEED_OK;
+}
+
+}  // namespace
+
+// This one covers OpenSSL RAND/EVP/ossl_prov_drbg_generate,
+// or reseeds Node.js's Crypto.getRandomBytes()/node::crypto::CSPRNG.
+//
+// however, see https://wiki.openssl.org/index.php/Random_fork-safety.
+int nreseed_reseed_openssl(void) {
+  const int result = ReseedDRBG(RAND_get0_primary(NULL));
+  if (result != NRESEED_OK) {
+    return result;
+  }
+
+  return nreseed_reseed_openssl_thread();
+}
+
+// Public and private DRBGs are thread local, so no lock but the DRBG's own.
+int nreseed_reseed_openssl_thread(void) {
+  const int result = ReseedDRBG(RAND_get0_public(NULL));
+  if (result != NRESEED_OK) {
+    return result;
+  }
+
+  return ReseedDRBG(RAND_get0_private(NULL));
+}
+
+int nreseed_add_hook(nreseed_hook hook, void* data) {
+  std::lock_guard<std::recursive_mutex> lock(registry_mutex);
+
+  try {
+    registry.emplace_back(hook, data);
+  } catch (const std::bad_alloc&) {
+    return NRESEED_ENOMEM;
+  }
+
+  return NRESEED_OK;
+}
+
+int nreseed_remove_hook(nreseed_hook hook, void* data) {
+  std::lock_guard<std::recursive_mutex> lock(registry_mutex);
+
+  for (auto it = registry.begin(); it != registry.end(); ++it) {
+    if (it->first == hook && it->second == data) {
+      registry.erase(it);
+      return NRESEED_OK;
+    }
+  }
+
+  return NRESEED_ENOENT;
+}
+
+int nreseed_reseed_all(void) {
+  reseeded_generation.store(fork_generation, std::memory_order_relaxed);
+
+  const int result = nreseed_reseed_openssl();
+
+  // Hooks run locked, so once nreseed_remove_hook() returns the hook is not
+  // running anymore. They still may add or remove hooks, the lock is
+  // recursive and the loop runs over a copy.
+  std::lock_guard<std::recursive_mutex> lock(registry_mutex);
+  const std::vector<Hook> hooks = registry;
+
+  for (const Hook& hook : hooks) {
+    hook.first(hook.second);
+  }
+
+  return result;
+}
+
+int nreseed_check_fork(void) {
+  if (reseeded_generation.load(std::memory_order_relaxed) == fork_generation) {
+    return NRESEED_OK;
+  }
+
+  return nreseed_reseed_all();
+}
+
+const volatile uint32_t* nreseed_fork_generation(void) {
+  return &fork_generation;
+}
+
+int nreseed_install_fork_handler(void) {
+  static std::once_flag once;
+  static int result = NRESEED_OK;
+
+  std::call_once(once, [] {
+    if (pthread_atfork(AtForkPrepare, AtForkParent, AtForkChild) != 0) {
+      result = NRESEED_EATFORK;
+    }
+  });
+
+  return result;
+}
+
+}  // extern "C"
@@ -0,0 +1,96 @@
+/* nreseed: V8 compatible PRNG and process-wide reseeding, C ABI.
+ *
+ * This is the library the node.js addon is built on. Other native addons and
+ * embedders link it (static or shared, see binding.gyp) to get the same
+ * generator as PRNG and to take part in the same reseed registry: every hook
+ * added here runs on seeder.reseed() and, once the fork handler is installed,
+ * in the child of every fork(2) on its next use of the library.
+ *
+ * Generators are neither reentrant nor threadsafe, the registry is.
+ */
+
+#ifndef NRESEED_H
+#define NRESEED_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NRESEED_OK        0
+#define NRESEED_ENODRBG  -1  /* no OpenSSL DRBG */
+#define NRESEED_ERESEED  -2  /* OpenSSL DRBG reseed failed */
+#define NRESEED_ENOMEM   -3
+#define NRESEED_ENOENT   -4  /* no such hook */
+#define NRESEED_EATFORK  -5  /* pthread_atfork() failed */
+
+typedef struct nreseed_rng nreseed_rng;
+
+/* Creates a generator seeded from the entropy source. It is registered and
+ * reseeded by nreseed_reseed_all() until destroyed. */
+nreseed_rng* nreseed_rng_create(void);
+
+/* Creates a generator with a fixed seed. Fixed streams are not registered. */
+nreseed_rng* nreseed_rng_create_seeded(int64_t seed);
+
+void nreseed_rng_destroy(nreseed_rng* rng);
+
+void nreseed_rng_seed(nreseed_rng* rng, int64_t seed);
+void nreseed_rng_reseed(nreseed_rng* rng);
+
+/* Same stream as Math.random() / PRNG.random() for the same seed. */
+double nreseed_rng_next_double(nreseed_rng* rng);
+void nreseed_rng_fill_double(nreseed_rng* rng, double* out, size_t n);
+void nreseed_rng_fill_bytes(nreseed_rng* rng, void* out, size_t n);
+
+/* Next n (1..32) bits, served from the leftover bits of previous steps unless
+ * the generator is V8 compatible (off by default). With V8 compatibility
+ * every call spends a full step, as V8's Next(bits) does. */
+uint32_t nreseed_rng_next_bits(nreseed_rng* rng, int n);
+void nreseed_rng_set_v8_compatible(nreseed_rng* rng, int v8_compatible);
+
+/* Reseeds the OpenSSL primary DRBG and the public/private DRBGs of the calling
+ * thread. DRBGs of other threads are chained to the primary one and reseed
+ * themselves on their next use, as the primary reseed counter has changed. */
+int nreseed_reseed_openssl(void);
+
+/* Reseeds the public/private DRBGs of the calling thread only, to refresh
+ * other threads eagerly. Takes no global lock. */
+int nreseed_reseed_openssl_thread(void);
+
+typedef void (*nreseed_hook)(void* data);
+
+int nreseed_add_hook(nreseed_hook hook, void* data);
+
+/* Returns once the hook is not running anymore. */
+int nreseed_remove_hook(nreseed_hook hook, void* data);
+
+/* Reseeds OpenSSL, then runs every registered hook. */
+int nreseed_reseed_all(void);
+
+/* Makes every fork(2) child run nreseed_reseed_all() on its next use of the
+ * library. Idempotent. The handler itself only counts the fork and renews the
+ * registry lock, nothing else is touched in the handler.
+ *
+ * The deferred reseed still takes the locks of the OpenSSL DRBGs: if another
+ * thread of the parent (e.g. of the libuv threadpool) was inside a DRBG at
+ * fork time, its lock stays held in the child and the first use there
+ * blocks. Fork from a quiet process, or exec right away in the child. */
+int nreseed_install_fork_handler(void);
+
+/* Runs nreseed_reseed_all() if the process forked since it last ran, costs two
+ * loads otherwise. Generators of this library check on every draw, other
+ * users should call it before drawing from state of their own. */
+int nreseed_check_fork(void);
+
+/* The fork count behind nreseed_check_fork(), for polling without a call
+ * (e.g. from JS). It only changes in a fork child, before any other use. */
+const volatile uint32_t* nreseed_fork_generation(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
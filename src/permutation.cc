@@ -0,0 +1,149 @@
+#include "permutation.h"
+
+#include <algorithm>
+
+#include "prng.h"
+
+// Indices must stay exact as JS numbers.
+static constexpr uint64_t kMaxSize = uint64_t{1} << 53;
+
+void FeistelPermutation::Init(uint64_t n, v8::base::RandomNumberGenerator& rng) {
+  int bits = 2;
+  while (bits < 64 && (uint64_t{1} << bits) < n) {
+    bits += 2;
+  }
+
+  n_ = n;
+  half_bits_ = bits / 2;
+  half_mask_ = (uint64_t{1} << half_bits_) - 1;
+
+  for (uint64_t& key : keys_) {
+    key = static_cast<uint64_t>(rng.NextInt64());
+  }
+}
+
+Napi::Object Permutation::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func =
+      DefineClass(env,
+                  "Permutation", {
+                  InstanceMethod("size",  &Permutation::Size),
+                  InstanceMethod("at",    &Permutation::At),
+                  InstanceMethod("next",  &Permutation::Next),
+                  InstanceMethod("reset", &Permutation::Reset),
+                  InstanceMethod("fill",  &Permutation::Fill)});
+
+  exports.Set("Permutation", func);
+
+  return exports;
+}
+
+Permutation::Permutation(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<Permutation>(info) {
+  Napi::Env env = info.Env();
+
+  if (!info.Length() || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+    return;
+  }
+
+  const int64_t n = info[0].As<Napi::Number>().Int64Value();
+  if (n < 1 || static_cast<uint64_t>(n) > kMaxSize) {
+    Napi::RangeError::New(env, "Size out of range").ThrowAsJavaScriptException();
+    return;
+  }
+
+  // Keys are all that is needed from the generator.
+  RandomSource source;
+  if (!source.Init(env, info[1])) {
+    return;
+  }
+
+  this->permutation_.Init(static_cast<uint64_t>(n), source.rng());
+}
+
+Napi::Value Permutation::Size(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), static_cast<double>(this->permutation_.size()));
+}
+
+Napi::Value Permutation::At(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!info.Length() || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  const int64_t i = info[0].As<Napi::Number>().Int64Value();
+  if (i < 0 || static_cast<uint64_t>(i) >= this->permutation_.size()) {
+    Napi::RangeError::New(env, "Index out of range").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  return Napi::Number::New(env, static_cast<double>(this->permutation_.At(i)));
+}
+
+// Returns the next index of the permutation, or -1 once all were visited.
+Napi::Value Permutation::Next(const Napi::CallbackInfo& info) {
+  if (this->cursor_ >= this->permutation_.size()) {
+    return Napi::Number::New(info.Env(), -1);
+  }
+
+  return Napi::Number::New(info.Env(), static_cast<double>(this->permutation_.At(this->cursor_++)));
+}
+
+void Permutation::Reset(const Napi::CallbackInfo& info) {
+  this->cursor_ = 0;
+}
+
+// fill(out, start) writes at(start), at(start + 1), ... to out, which is a
+// Float64Array or, when the size fits, a Uint32Array. Stops at the end of the
+// permutation and returns the number of indices written.
+Napi::Value Permutation::Fill(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsTypedArray()) {
+    Napi::TypeError::New(env, "Float64Array or Uint32Array expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  uint64_t start = 0;
+  if (info.Length() > 1) {
+    if (!info[1].IsNumber() || info[1].As<Napi::Number>().Int64Value() < 0) {
+      Napi::TypeError::New(env, "Non-negative number expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    start = static_cast<uint64_t>(info[1].As<Napi::Number>().Int64Value());
+  }
+
+  const uint64_t n = this->permutation_.size();
+  const uint64_t left = start < n ? n - start : 0;
+
+  Napi::TypedArray out = info[0].As<Napi::TypedArray>();
+  const uint64_t length = std::min<uint64_t>(out.ElementLength(), left);
+
+  switch (out.TypedArrayType()) {
+  case napi_float64_array: {
+    double* data = out.As<Napi::Float64Array>().Data();
+    for (uint64_t i = 0; i < length; i++) {
+      data[i] = static_cast<double>(this->permutation_.At(start + i));
+    }
+    break;
+  }
+  case napi_uint32_array: {
+    if (n - 1 > UINT32_MAX) {
+      Napi::RangeError::New(env, "Size does not fit Uint32Array").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    uint32_t* data = out.As<Napi::Uint32Array>().Data();
+    for (uint64_t i = 0; i < length; i++) {
+      data[i] = static_cast<uint32_t>(this->permutation_.At(start + i));
+    }
+    break;
+  }
+  default:
+    Napi::TypeError::New(env, "Float64Array or Uint32Array expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  return Napi::Number::New(env, static_cast<double>(length));
+}
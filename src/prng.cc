@@ -1,12 +1,27 @@
 #include "prng.h"
 
+#include "shared_streams.h"
+
+// Instances are recognized by a type tag rather than by InstanceOf() against
+// a constructor: a static reference would belong to whichever env (main thread
+// or worker) initialized the addon last.
+static const napi_type_tag kPRNGTypeTag = {0x6e72657365656470, 0x726e672d74616731};
+
 Napi::Object PRNG::Init(Napi::Env env, Napi::Object exports) {
   Napi::Function func =
       DefineClass(env,
                   "PRNG", {
                   InstanceMethod("random",  &PRNG::Random),
                   InstanceMethod("setSeed", &PRNG::SetSeed),
-                  InstanceMethod("reseed",  &PRNG::Reseed)});
+                  InstanceMethod("reseed",  &PRNG::Reseed),
+                  InstanceMethod("sharedState", &PRNG::SharedState),
+                  InstanceMethod("record",  &PRNG::Record),
+                  InstanceMethod("replay",  &PRNG::Replay),
+                  InstanceMethod("stop",    &PRNG::Stop),
+                  InstanceMethod("seek",    &PRNG::Seek),
+                  InstanceMethod("bools",   &PRNG::Bools),
+                  InstanceMethod("bits",    &PRNG::Bits),
+                  InstanceMethod("setV8Compatible", &PRNG::SetV8Compatible)});
 
   exports.Set("PRNG", func);
 
@@ -17,11 +32,14 @@ PRNG::PRNG(const Napi::CallbackInfo& info)
     : Napi::ObjectWrap<PRNG>(info) {
   Napi::Env env = info.Env();
 
+  napi_type_tag_object(env, info.This(), &kPRNGTypeTag);
+
   const int length = info.Length();
 
   if (length == 0) {
     this->value_ = v8::base::RandomNumberGenerator(0);
     this->value_.Reseed();
+    this->from_entropy_ = true;
     return;
   } else if (length != 1) {
     Napi::TypeError::New(env, "Expected 1 argument max").ThrowAsJavaScriptException();
@@ -37,9 +55,74 @@ PRNG::PRNG(const Napi::CallbackInfo& info)
   this->value_ = v8::base::RandomNumberGenerator(seed);
 }
 
+PRNG::~PRNG() {
+  if (shared()) {
+    nreseed_remove_hook(ReseedShared, this);
+  }
+}
+
+PRNG* PRNG::Unwrap(const Napi::Value& value) {
+  if (!value.IsObject()) {
+    return nullptr;
+  }
+
+  bool tagged = false;
+  if (napi_check_object_type_tag(value.Env(), value, &kPRNGTypeTag, &tagged) != napi_ok || !tagged) {
+    return nullptr;
+  }
+
+  PRNG* prng = ObjectWrap<PRNG>::Unwrap(value.As<Napi::Object>());
+  return prng->shared() || prng->log_ ? nullptr : prng;
+}
+
+void PRNG::CheckFork() {
+  if (!this->fork_.Forked() || shared() || this->log_) {
+    return;
+  }
+
+  if (!this->streams_.IsEmpty()) {
+    // The parent goes on with the claimed stream, the child takes the next.
+    SharedStreams::Unwrap(this->streams_.Value())->ClaimNext(this->value_);
+  } else if (this->from_entropy_) {
+    this->value_.Reseed();
+  }
+}
+
 Napi::Value PRNG::Random(const Napi::CallbackInfo& info) {
+  CheckFork();
+
+  if (this->log_) {
+    double num;
+
+    if (this->log_->recording()) {
+      if (!this->log_->Record(this->value_, &num)) {
+        // The log keeps the draws up to here and the generator is where it
+        // left off, replaying the log and going on live gives the same stream.
+        std::unique_ptr<ReplayLog> log = std::move(this->log_);
+        log->Close();
+        Napi::Error::New(info.Env(), log->error()).ThrowAsJavaScriptException();
+        return info.Env().Null();
+      }
+    } else if (!this->log_->Replay(&num)) {
+      // Past the end of the log the recorded stream goes on live.
+      this->log_->Restore(this->value_);
+      this->log_.reset();
+      num = this->value_.NextDouble();
+    }
+
+    return Napi::Number::New(info.Env(), num);
+  }
+
+  if (shared()) {
+    Load();
+  }
+
   const double num = this->value_.NextDouble();
 
+  if (shared()) {
+    Store();
+  }
+
   return Napi::Number::New(info.Env(), num);
 }
 
@@ -51,13 +134,353 @@ void PRNG::SetSeed(const Napi::CallbackInfo& info) {
     return;
   }
 
+  if (this->log_ && this->log_->recording()) {
+    Napi::Error::New(env, "Cannot seed while recording").ThrowAsJavaScriptException();
+    return;
+  }
+
   const Napi::Number value = info[0].As<Napi::Number>();
   const int64_t seed = value.Int64Value();
 
+  this->log_.reset();
   this->value_.SetSeed(seed);
+  this->from_entropy_ = false;
+  this->streams_.Reset();
+
+  if (shared()) {
+    this->seen_reseeds_ = reseeds();
+    Store();
+  }
 }
 
 void PRNG::Reseed(const Napi::CallbackInfo& info) {
+  if (this->log_ && this->log_->recording()) {
+    Napi::Error::New(info.Env(), "Cannot seed while recording").ThrowAsJavaScriptException();
+    return;
+  }
+
+  this->log_.reset();
   this->value_.Reseed();
+  this->from_entropy_ = true;
+  this->streams_.Reset();
+
+  if (shared()) {
+    this->seen_reseeds_ = reseeds();
+    Store();
+  }
+}
+
+// Random draws other than random() are not logged, so they are refused while
+// recording or replaying.
+bool PRNG::CheckNotLogging(Napi::Env env) {
+  if (this->log_) {
+    Napi::Error::New(env, "Cannot draw bits while recording or replaying").ThrowAsJavaScriptException();
+    return false;
+  }
+  return true;
+}
+
+// Samplers draw from value_ directly. While recording their draws would be
+// missing from the log, while replaying Restore() would rewind value_ under
+// them and they would repeat their numbers.
+bool PRNG::CheckNotBorrowed(Napi::Env env) {
+  if (*this->borrowers_ != 0) {
+    Napi::Error::New(env, "PRNG is in use by a sampler").ThrowAsJavaScriptException();
+    return false;
+  }
+  return true;
+}
+
+// bools(out) sets every byte of a Uint8Array to 0 or 1, one bit per element.
+Napi::Value PRNG::Bools(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!info.Length() || !info[0].IsTypedArray() ||
+      info[0].As<Napi::TypedArray>().TypedArrayType() != napi_uint8_array) {
+    Napi::TypeError::New(env, "Uint8Array expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  if (!CheckNotLogging(env)) {
+    return env.Null();
+  }
+
+  CheckFork();
+
+  Napi::Uint8Array out = info[0].As<Napi::Uint8Array>();
+  uint8_t* data = out.Data();
+  const size_t length = out.ElementLength();
+
+  if (shared()) {
+    Load();
+  }
+
+  for (size_t i = 0; i < length; i++) {
+    data[i] = this->value_.NextBool();
+  }
+
+  if (shared()) {
+    Store();
+  }
+
+  return out;
+}
+
+// bits(n) returns the next n (1..32) random bits as an unsigned number.
+Napi::Value PRNG::Bits(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!info.Length() || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  const int64_t n = info[0].As<Napi::Number>().Int64Value();
+  if (n < 1 || n > 32) {
+    Napi::RangeError::New(env, "Number of bits out of range").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  if (!CheckNotLogging(env)) {
+    return env.Null();
+  }
+
+  CheckFork();
+
+  if (shared()) {
+    Load();
+  }
+
+  const uint32_t bits = this->value_.NextBits(static_cast<int>(n));
+
+  if (shared()) {
+    Store();
+  }
+
+  return Napi::Number::New(env, bits);
+}
+
+// setV8Compatible(true) makes bools() and bits() spend a generator step per
+// call like V8 does, instead of serving them from leftover bits.
+void PRNG::SetV8Compatible(const Napi::CallbackInfo& info) {
+  this->value_.set_v8_compatible(info.Length() > 0 && info[0].ToBoolean().Value());
+}
+
+// Switches the instance into the shared state mode and returns the state as
+// Uint32Array, for the JS engine of seeder.fastRandom(). The instance is then
+// reseeded by seeder.reseed() and libnreseed fork handler along with the rest.
+Napi::Value PRNG::SharedState(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (this->log_) {
+    Napi::Error::New(env, "Cannot share state while recording or replaying").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  // A sampler steps value_ without going through the buffer, the next Load()
+  // would rewind it and repeat the sampler's numbers.
+  if (!CheckNotBorrowed(env)) {
+    return env.Null();
+  }
+
+  if (!shared()) {
+    // Shared state is reseeded on request from here on, like in a forked
+    // child, a stream claim is not renewed anymore.
+    this->streams_.Reset();
+
+    Napi::ArrayBuffer buffer = Napi::ArrayBuffer::New(env, kSharedWords * sizeof(uint32_t));
+    this->shared_ = Napi::Persistent(buffer);
+    this->shared_state_ = static_cast<uint32_t*>(buffer.Data());
+    this->shared_state_[kReseedWord] = 0;
+    this->seen_reseeds_ = 0;
+    Store();
+
+    if (nreseed_add_hook(ReseedShared, this) != NRESEED_OK) {
+      Napi::Error::New(env, "nreseed_add_hook failed").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+  }
+
+  return Napi::Uint32Array::New(env, kSharedWords, this->shared_.Value(), 0, napi_uint32_array);
+}
+
+void PRNG::Load() {
+  const uint32_t requested = reseeds();
+  if (requested != this->seen_reseeds_) {
+    this->seen_reseeds_ = requested;
+    this->value_.Reseed();
+    Store();
+    return;
+  }
+
+  const uint32_t* s = this->shared_state_;
+  const uint64_t state0 = uint64_t{s[1]} << 32 | s[0];
+  const uint64_t state1 = uint64_t{s[3]} << 32 | s[2];
+
+  // Unchanged state keeps the bit reservoir, anything else drops it.
+  if (state0 != this->value_.state0() || state1 != this->value_.state1()) {
+    this->value_.SetState(state0, state1);
+  }
+}
+
+// record(path[, interval]) logs every following draw to a memory-mapped file,
+// with a state checkpoint every interval (65536) draws, until stop().
+void PRNG::Record(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!info.Length() || !info[0].IsString()) {
+    Napi::TypeError::New(env, "String expected").ThrowAsJavaScriptException();
+    return;
+  }
+
+  int64_t interval = 65536;
+  if (info.Length() > 1 && !info[1].IsUndefined()) {
+    if (!info[1].IsNumber()) {
+      Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+      return;
+    }
+    interval = info[1].As<Napi::Number>().Int64Value();
+  }
+
+  if (interval < 1 || interval > (1 << 24)) {
+    Napi::RangeError::New(env, "Checkpoint interval out of range").ThrowAsJavaScriptException();
+    return;
+  }
+
+  if (shared() || this->log_) {
+    Napi::Error::New(env, "Already recording, replaying or sharing state").ThrowAsJavaScriptException();
+    return;
+  }
+
+  if (!CheckNotBorrowed(env)) {
+    return;
+  }
+
+  std::unique_ptr<ReplayLog> log(new ReplayLog());
+  if (!log->OpenForRecording(info[0].As<Napi::String>().Utf8Value(), this->value_, interval)) {
+    Napi::Error::New(env, log->error()).ThrowAsJavaScriptException();
+    return;
+  }
+
+  this->log_ = std::move(log);
+}
+
+// replay(path) serves draws straight from a recorded log, and continues with
+// the live generator where the log ends.
+void PRNG::Replay(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!info.Length() || !info[0].IsString()) {
+    Napi::TypeError::New(env, "String expected").ThrowAsJavaScriptException();
+    return;
+  }
+
+  if (shared() || (this->log_ && this->log_->recording())) {
+    Napi::Error::New(env, "Already recording or sharing state").ThrowAsJavaScriptException();
+    return;
+  }
+
+  if (!CheckNotBorrowed(env)) {
+    return;
+  }
+
+  std::unique_ptr<ReplayLog> log(new ReplayLog());
+  if (!log->OpenForReplay(info[0].As<Napi::String>().Utf8Value())) {
+    Napi::Error::New(env, log->error()).ThrowAsJavaScriptException();
+    return;
+  }
+
+  this->log_ = std::move(log);
+}
+
+// Finishes a recording, or leaves a replay with the generator in the state of
+// the current position.
+void PRNG::Stop(const Napi::CallbackInfo& info) {
+  if (!this->log_) {
+    return;
+  }
+
+  std::unique_ptr<ReplayLog> log = std::move(this->log_);
+  if (!log->recording()) {
+    log->Restore(this->value_);
+  }
+
+  if (!log->Close()) {
+    Napi::Error::New(info.Env(), log->error()).ThrowAsJavaScriptException();
+  }
+}
+
+// seek(i) moves a replay to the i-th recorded draw.
+void PRNG::Seek(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!info.Length() || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+    return;
+  }
+
+  if (!this->log_ || this->log_->recording()) {
+    Napi::Error::New(env, "Not replaying").ThrowAsJavaScriptException();
+    return;
+  }
+
+  const int64_t i = info[0].As<Napi::Number>().Int64Value();
+  if (i < 0 || !this->log_->Seek(static_cast<uint64_t>(i))) {
+    Napi::RangeError::New(env, "Position out of range").ThrowAsJavaScriptException();
+  }
+}
+
+void PRNG::Store() {
+  uint32_t* s = this->shared_state_;
+  const uint64_t state0 = this->value_.state0();
+  const uint64_t state1 = this->value_.state1();
+
+  s[0] = static_cast<uint32_t>(state0);
+  s[1] = static_cast<uint32_t>(state0 >> 32);
+  s[2] = static_cast<uint32_t>(state1);
+  s[3] = static_cast<uint32_t>(state1 >> 32);
+}
+
+uint32_t PRNG::reseeds() const {
+  return __atomic_load_n(&this->shared_state_[kReseedWord], __ATOMIC_ACQUIRE);
+}
+
+// Runs on whatever thread calls nreseed_reseed_all(). Rewriting the state
+// here would race with a step in progress on the owning thread (native or JS)
+// and either tear it or be overwritten by it, so it only files a request.
+void PRNG::ReseedShared(void* data) {
+  PRNG* prng = static_cast<PRNG*>(data);
+
+  __atomic_fetch_add(&prng->shared_state_[kReseedWord], 1, __ATOMIC_RELEASE);
+}
+
+RandomSource::~RandomSource() {
+  if (this->borrowed_) {
+    --*this->borrowed_;
+  }
 }
 
+bool RandomSource::Init(Napi::Env env, const Napi::Value& value) {
+  if (value.IsUndefined()) {
+    this->own_.Reseed();
+    this->from_entropy_ = true;
+    return true;
+  }
+
+  if (value.IsNumber()) {
+    this->own_.SetSeed(value.As<Napi::Number>().Int64Value());
+    return true;
+  }
+
+  PRNG* prng = PRNG::Unwrap(value);
+  if (prng == nullptr) {
+    Napi::TypeError::New(env, "PRNG (not sharing state, recording or replaying) or Number expected").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  this->ref_ = Napi::Persistent(value.As<Napi::Object>());
+  this->prng_ = prng;
+  this->borrowed_ = this->prng_->borrowers_;
+  ++*this->borrowed_;
+  return true;
+}
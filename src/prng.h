@@ -3,21 +3,149 @@
 
 #include <napi.h>
 
+#include <memory>
+
+#include "nreseed.h"
+#include "replay_log.h"
 #include "utils/random-number-generator.h"
 
+// Tells a generator seeded from the entropy source that it runs in a forked
+// child now, on the first draw there (once reseedOnFork() installed the fork
+// handler), so that it reseeds instead of repeating the stream of the parent.
+// Generators with a fixed seed go on deterministically.
+class ForkWatch {
+ public:
+  ForkWatch() : generation_(*nreseed_fork_generation()) {}
+
+  // Also runs nreseed_check_fork() for OpenSSL and the registry.
+  bool Forked() {
+    nreseed_check_fork();
+
+    const uint32_t generation = *nreseed_fork_generation();
+    if (generation == this->generation_) {
+      return false;
+    }
+
+    this->generation_ = generation;
+    return true;
+  }
+
+ private:
+  uint32_t generation_;
+};
+
 // Object that provides original node.js PRNG (Math.random()).
 class PRNG : public Napi::ObjectWrap<PRNG> {
  public:
   static Napi::Object Init(Napi::Env env, Napi::Object exports);
 
   PRNG(const Napi::CallbackInfo& info);
+  ~PRNG();
+
+  // Returns the instance behind |value| if it is a PRNG that is not sharing
+  // state, recording or replaying, nullptr otherwise.
+  static PRNG* Unwrap(const Napi::Value& value);
 
  private:
+  friend class RandomSource;
+  friend class SharedStreams;
+
   Napi::Value Random(const Napi::CallbackInfo& info);
   void SetSeed(const Napi::CallbackInfo& info);
   void Reseed(const Napi::CallbackInfo& info);
+  Napi::Value SharedState(const Napi::CallbackInfo& info);
+  void Record(const Napi::CallbackInfo& info);
+  void Replay(const Napi::CallbackInfo& info);
+  void Stop(const Napi::CallbackInfo& info);
+  void Seek(const Napi::CallbackInfo& info);
+  Napi::Value Bools(const Napi::CallbackInfo& info);
+  Napi::Value Bits(const Napi::CallbackInfo& info);
+  void SetV8Compatible(const Napi::CallbackInfo& info);
+
+  bool CheckNotLogging(Napi::Env env);
+  // Throws if a RandomSource borrows value_, for the modes it can't follow.
+  bool CheckNotBorrowed(Napi::Env env);
+
+  // Reseeds a generator seeded from the entropy source on its first draw in
+  // a forked child, or claims a fresh stream if it was claimed from a
+  // SharedStreams. Shared state is reseeded through ReseedShared() instead,
+  // and logged draws stay as recorded.
+  void CheckFork();
+
+  // In the shared state mode the state lives in a JS buffer as four uint32
+  // words (state0 low, high, state1 low, high) and value_ is a scratch copy.
+  // Only the thread of the owning env writes them. A fifth word counts reseed
+  // requests, which may come from any thread: the owner reseeds on its next
+  // draw once the count moves, and so does the JS step of fastRandom().
+  static constexpr size_t kSharedWords = 5;
+  static constexpr size_t kReseedWord = 4;
+
+  bool shared() const { return this->shared_state_ != nullptr; }
+  void Load();
+  void Store();
+  uint32_t reseeds() const;
+  static void ReseedShared(void* data);
 
   v8::base::RandomNumberGenerator value_;
+  bool from_entropy_ = false;
+  ForkWatch fork_;
+
+  // The SharedStreams that value_ was claimed from, see SharedStreams::claim().
+  Napi::ObjectReference streams_;
+
+  Napi::Reference<Napi::ArrayBuffer> shared_;
+  uint32_t* shared_state_ = nullptr;
+  uint32_t seen_reseeds_ = 0;
+
+  // Recording or replaying draws, see record() and replay().
+  std::unique_ptr<ReplayLog> log_;
+
+  // Number of RandomSources drawing from value_ directly. Shared by both
+  // sides, so that neither depends on the order of finalization.
+  std::shared_ptr<uint32_t> borrowers_ = std::make_shared<uint32_t>(0);
+};
+
+// Generator argument of the native samplers. It is either borrowed from a PRNG
+// instance (which is kept alive while referenced), or owned and seeded with a
+// number, or reseeded from the entropy source when the argument is undefined.
+class RandomSource {
+ public:
+  RandomSource() = default;
+  ~RandomSource();
+
+  RandomSource(const RandomSource&) = delete;
+  RandomSource& operator=(const RandomSource&) = delete;
+
+  // Throws a TypeError and returns false if |value| is none of the above.
+  bool Init(Napi::Env env, const Napi::Value& value);
+
+  // Generators seeded from the entropy source reseed on their first draw in
+  // a forked child, see ForkWatch.
+  v8::base::RandomNumberGenerator& rng() {
+    if (this->prng_ != nullptr) {
+      this->prng_->CheckFork();
+      return this->prng_->value_;
+    }
+
+    if (this->fork_.Forked() && this->from_entropy_) {
+      this->own_.Reseed();
+    }
+    return this->own_;
+  }
+
+  // Whether the generator was last seeded from the entropy source.
+  bool from_entropy() const {
+    return this->prng_ != nullptr ? this->prng_->from_entropy_ : this->from_entropy_;
+  }
+
+ private:
+  Napi::ObjectReference ref_;
+  PRNG* prng_ = nullptr;
+  std::shared_ptr<uint32_t> borrowed_;
+
+  v8::base::RandomNumberGenerator own_;
+  bool from_entropy_ = false;
+  ForkWatch fork_;
 };
 
 #endif
@@ -0,0 +1,204 @@
+#include "prng_pool.h"
+
+#include <limits>
+
+#include "utils/bit_cast.h"
+
+Napi::Object PRNGPool::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func =
+      DefineClass(env,
+                  "PRNGPool", {
+                  InstanceMethod("size",       &PRNGPool::Size),
+                  InstanceMethod("random",     &PRNGPool::Random),
+                  InstanceMethod("randomInto", &PRNGPool::RandomInto),
+                  InstanceMethod("fill",       &PRNGPool::Fill),
+                  InstanceMethod("setSeed",    &PRNGPool::SetSeed),
+                  InstanceMethod("reseed",     &PRNGPool::Reseed)});
+
+  exports.Set("PRNGPool", func);
+
+  return exports;
+}
+
+PRNGPool::PRNGPool(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<PRNGPool>(info) {
+  Napi::Env env = info.Env();
+
+  if (!info.Length() || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+    return;
+  }
+
+  const int64_t n = info[0].As<Napi::Number>().Int64Value();
+  if (n < 1 || n > std::numeric_limits<uint32_t>::max()) {
+    Napi::RangeError::New(env, "Pool size out of range").ThrowAsJavaScriptException();
+    return;
+  }
+
+  this->state0_.resize(n);
+  this->state1_.resize(n);
+
+  if (info.Length() < 2 || info[1].IsUndefined()) {
+    ReseedAll();
+    return;
+  } else if (!info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+    return;
+  }
+
+  SeedAll(info[1].As<Napi::Number>().Int64Value());
+}
+
+// Same as RandomNumberGenerator::SetSeed().
+void PRNGPool::Seed(size_t i, int64_t seed) {
+  using v8::base::RandomNumberGenerator;
+
+  this->state0_[i] = RandomNumberGenerator::MurmurHash3(v8::base::bit_cast<uint64_t>(seed));
+  this->state1_[i] = RandomNumberGenerator::MurmurHash3(~this->state0_[i]);
+}
+
+void PRNGPool::SeedAll(int64_t base) {
+  const size_t n = this->state0_.size();
+  for (size_t i = 0; i < n; i++) {
+    Seed(i, static_cast<int64_t>(static_cast<uint64_t>(base) + i));
+  }
+}
+
+Napi::Value PRNGPool::Size(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), static_cast<double>(this->state0_.size()));
+}
+
+Napi::Value PRNGPool::Random(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!info.Length() || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  const int64_t i = info[0].As<Napi::Number>().Int64Value();
+  if (i < 0 || static_cast<uint64_t>(i) >= this->state0_.size()) {
+    Napi::RangeError::New(env, "Index out of range").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  CheckFork();
+
+  return Napi::Number::New(env, Next(i));
+}
+
+// Advances streams indices[j] and writes their doubles to out[j].
+Napi::Value PRNGPool::RandomInto(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() != 2 ||
+      !info[0].IsTypedArray() || info[0].As<Napi::TypedArray>().TypedArrayType() != napi_uint32_array ||
+      !info[1].IsTypedArray() || info[1].As<Napi::TypedArray>().TypedArrayType() != napi_float64_array) {
+    Napi::TypeError::New(env, "Expected randomInto(Uint32Array, Float64Array)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Uint32Array indices = info[0].As<Napi::Uint32Array>();
+  Napi::Float64Array out = info[1].As<Napi::Float64Array>();
+
+  const size_t length = indices.ElementLength();
+  if (out.ElementLength() < length) {
+    Napi::RangeError::New(env, "Output is shorter than indices").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  const uint32_t* index = indices.Data();
+  const size_t n = this->state0_.size();
+  for (size_t j = 0; j < length; j++) {
+    if (index[j] >= n) {
+      Napi::RangeError::New(env, "Index out of range").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+  }
+
+  CheckFork();
+
+  double* data = out.Data();
+  for (size_t j = 0; j < length; j++) {
+    data[j] = Next(index[j]);
+  }
+
+  return out;
+}
+
+// Advances streams [0, out.length) by one step each. There are no
+// dependencies between iterations, so the loop vectorizes.
+Napi::Value PRNGPool::Fill(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!info.Length() || !info[0].IsTypedArray() ||
+      info[0].As<Napi::TypedArray>().TypedArrayType() != napi_float64_array) {
+    Napi::TypeError::New(env, "Float64Array expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Float64Array out = info[0].As<Napi::Float64Array>();
+
+  const size_t length = out.ElementLength();
+  if (length > this->state0_.size()) {
+    Napi::RangeError::New(env, "Output is longer than the pool").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  CheckFork();
+
+  uint64_t* __restrict state0 = this->state0_.data();
+  uint64_t* __restrict state1 = this->state1_.data();
+  double* __restrict data = out.Data();
+
+  for (size_t i = 0; i < length; i++) {
+    uint64_t s1 = state0[i];
+    const uint64_t s0 = state1[i];
+    s1 ^= s1 << 23;
+    s1 ^= s1 >> 17;
+    s1 ^= s0;
+    s1 ^= s0 >> 26;
+    state0[i] = s0;
+    state1[i] = s1;
+    data[i] = v8::base::RandomNumberGenerator::ToDouble(s0);
+  }
+
+  return out;
+}
+
+void PRNGPool::SetSeed(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() != 2 || !info[0].IsNumber() || !info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Expected setSeed(index, seed)").ThrowAsJavaScriptException();
+    return;
+  }
+
+  const int64_t i = info[0].As<Napi::Number>().Int64Value();
+  if (i < 0 || static_cast<uint64_t>(i) >= this->state0_.size()) {
+    Napi::RangeError::New(env, "Index out of range").ThrowAsJavaScriptException();
+    return;
+  }
+
+  Seed(i, info[1].As<Napi::Number>().Int64Value());
+  this->from_entropy_ = false;
+}
+
+void PRNGPool::Reseed(const Napi::CallbackInfo& info) {
+  ReseedAll();
+}
+
+// Reseeds every stream from a single draw of the entropy source.
+void PRNGPool::ReseedAll() {
+  v8::base::RandomNumberGenerator rng;
+  rng.Reseed();
+
+  SeedAll(rng.NextInt64());
+  this->from_entropy_ = true;
+}
+
+void PRNGPool::CheckFork() {
+  if (this->fork_.Forked() && this->from_entropy_) {
+    ReseedAll();
+  }
+}
@@ -0,0 +1,51 @@
+#ifndef PRNG_POOL_H
+#define PRNG_POOL_H
+
+#include <napi.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "prng.h"
+#include "utils/random-number-generator.h"
+
+// Object that holds n independent PRNG streams addressed by index. States are
+// kept as two contiguous arrays (16 bytes per stream, no JS object per stream),
+// and stream i seeded with s is the same stream as new PRNG(s).
+class PRNGPool : public Napi::ObjectWrap<PRNGPool> {
+ public:
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+  PRNGPool(const Napi::CallbackInfo& info);
+
+ private:
+  Napi::Value Size(const Napi::CallbackInfo& info);
+  Napi::Value Random(const Napi::CallbackInfo& info);
+  Napi::Value RandomInto(const Napi::CallbackInfo& info);
+  Napi::Value Fill(const Napi::CallbackInfo& info);
+  void SetSeed(const Napi::CallbackInfo& info);
+  void Reseed(const Napi::CallbackInfo& info);
+
+  // Seeds streams [0, n) with base + i.
+  void SeedAll(int64_t base);
+  void ReseedAll();
+  void Seed(size_t i, int64_t seed);
+
+  // Reseeds a pool seeded from the entropy source on its first draw in a
+  // forked child, see ForkWatch. Once a stream got a fixed seed the pool stays
+  // deterministic.
+  void CheckFork();
+
+  double Next(size_t i) {
+    v8::base::RandomNumberGenerator::XorShift128(&this->state0_[i], &this->state1_[i]);
+    return v8::base::RandomNumberGenerator::ToDouble(this->state0_[i]);
+  }
+
+  std::vector<uint64_t> state0_;
+  std::vector<uint64_t> state1_;
+
+  bool from_entropy_ = false;
+  ForkWatch fork_;
+};
+
+#endif
@@ -0,0 +1,380 @@
+#include "quasi_random.h"
+
+#include <iterator>
+#include <utility>
+
+#include "prng.h"
+#include "sobol_directions.h"
+#include "utils/macros.h"
+
+namespace {
+
+// a * b mod p over GF(2), where p has the given degree.
+uint32_t MulMod(uint32_t a, uint32_t b, uint32_t p, int degree) {
+  uint32_t result = 0;
+  while (b != 0) {
+    if (b & 1) {
+      result ^= a;
+    }
+    b >>= 1;
+    a <<= 1;
+    if ((a >> degree) & 1) {
+      a ^= p;
+    }
+  }
+  return result;
+}
+
+// x^e mod p over GF(2).
+uint32_t PowX(uint64_t e, uint32_t p, int degree) {
+  uint32_t base = 2;
+  if ((base >> degree) & 1) {
+    base ^= p;
+  }
+
+  uint32_t result = 1;
+  for (; e != 0; e >>= 1) {
+    if (e & 1) {
+      result = MulMod(result, base, p, degree);
+    }
+    base = MulMod(base, base, p, degree);
+  }
+  return result;
+}
+
+int Degree(uint32_t p) {
+  return 31 - __builtin_clz(p);
+}
+
+// p is primitive iff x has order 2^degree - 1 modulo p.
+bool IsPrimitive(uint32_t p) {
+  const int degree = Degree(p);
+  const uint64_t order = (uint64_t{1} << degree) - 1;
+
+  if (PowX(order, p, degree) != 1) {
+    return false;
+  }
+
+  uint64_t rest = order;
+  for (uint64_t q = 2; rest > 1; q++) {
+    // What is left once q^2 exceeds it is a prime.
+    if (q * q > rest) {
+      q = rest;
+    }
+    if (rest % q != 0) {
+      continue;
+    }
+    while (rest % q == 0) {
+      rest /= q;
+    }
+    if (PowX(order / q, p, degree) == 1) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Direction numbers of SobolEngine::kMaxDimensions dimensions, 32 per
+// dimension, v[k] = m[k] / 2^(k + 1). Primitive polynomials are enumerated in
+// the order of the Joe-Kuo table, the initial m[k] come from that table.
+const std::vector<uint32_t>& SobolDirections() {
+  static const std::vector<uint32_t> directions = [] {
+    constexpr size_t kBits = 32;
+
+    std::vector<uint32_t> v(SobolEngine::kMaxDimensions * kBits);
+    for (size_t k = 0; k < kBits; k++) {
+      v[k] = uint32_t{1} << (31 - k);
+    }
+
+    const uint16_t* initial = kSobolInitialDirections;
+
+    size_t d = 1;
+    for (uint32_t p = 3; d < SobolEngine::kMaxDimensions; p += 2) {
+      if (!IsPrimitive(p)) {
+        continue;
+      }
+
+      const int s = Degree(p);
+      uint32_t m[kBits];
+
+      for (int k = 0; k < s; k++) {
+        m[k] = *initial++;
+      }
+
+      for (size_t k = s; k < kBits; k++) {
+        m[k] = m[k - s] ^ (m[k - s] << s);
+        for (int j = 1; j < s; j++) {
+          if ((p >> (s - j)) & 1) {
+            m[k] ^= m[k - j] << j;
+          }
+        }
+      }
+
+      for (size_t k = 0; k < kBits; k++) {
+        v[d * kBits + k] = m[k] << (31 - k);
+      }
+      d++;
+    }
+
+    // Every entry used, so polynomials and table lines are in step.
+    CHECK_EQ(initial, std::end(kSobolInitialDirections));
+
+    return v;
+  }();
+
+  return directions;
+}
+
+uint32_t ReverseBits(uint32_t x) {
+  x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+  x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+  x = ((x >> 4) & 0x0f0f0f0fu) | ((x & 0x0f0f0f0fu) << 4);
+  x = ((x >> 8) & 0x00ff00ffu) | ((x & 0x00ff00ffu) << 8);
+  return (x >> 16) | (x << 16);
+}
+
+// Laine-Karras style hash on reversed bits is a nested uniform scramble.
+uint32_t NestedUniformScramble(uint32_t x, uint32_t seed) {
+  x = ReverseBits(x);
+  x += seed;
+  x ^= x * 0x6c50b47cu;
+  x ^= x * 0xb82f1e52u;
+  x ^= x * 0xc7afe638u;
+  x ^= x * 0x8d22f6e6u;
+  return ReverseBits(x);
+}
+
+std::vector<uint32_t> Primes(size_t count) {
+  std::vector<uint32_t> primes;
+  for (uint32_t n = 2; primes.size() < count; n++) {
+    bool prime = true;
+    for (uint32_t p : primes) {
+      if (p * p > n) {
+        break;
+      }
+      if (n % p == 0) {
+        prime = false;
+        break;
+      }
+    }
+    if (prime) {
+      primes.push_back(n);
+    }
+  }
+  return primes;
+}
+
+}  // namespace
+
+void SobolEngine::Init(size_t dimensions, v8::base::RandomNumberGenerator& rng, bool scramble) {
+  dimensions_ = dimensions;
+  directions_.assign(SobolDirections().begin(), SobolDirections().begin() + dimensions * kBits);
+  x_.assign(dimensions, 0);
+  index_ = 0;
+
+  seeds_.clear();
+  if (scramble) {
+    for (size_t d = 0; d < dimensions; d++) {
+      seeds_.push_back(static_cast<uint32_t>(rng.NextInt()));
+    }
+  }
+}
+
+void SobolEngine::Seek(uint64_t index) {
+  const uint64_t gray = index ^ (index >> 1);
+
+  for (size_t d = 0; d < dimensions_; d++) {
+    uint32_t x = 0;
+    for (int k = 0; k < kBits; k++) {
+      if ((gray >> k) & 1) {
+        x ^= directions_[d * kBits + k];
+      }
+    }
+    x_[d] = x;
+  }
+
+  index_ = index;
+}
+
+void SobolEngine::Next(double* out, size_t stride) {
+  static constexpr double k2Pow32 = 4294967296.0;
+
+  const bool scrambled = !seeds_.empty();
+  for (size_t d = 0; d < dimensions_; d++) {
+    const uint32_t x = scrambled ? NestedUniformScramble(x_[d], seeds_[d]) : x_[d];
+    out[d * stride] = x / k2Pow32;
+  }
+
+  // Gray code order: the next point differs in one direction number.
+  const int k = __builtin_ctzll(++index_);
+  if (k < kBits) {
+    for (size_t d = 0; d < dimensions_; d++) {
+      x_[d] ^= directions_[d * kBits + k];
+    }
+  }
+}
+
+void HaltonEngine::Init(size_t dimensions, v8::base::RandomNumberGenerator& rng, bool scramble) {
+  bases_ = Primes(dimensions);
+  offsets_.clear();
+  permutations_.clear();
+  index_ = 0;
+
+  if (!scramble) {
+    return;
+  }
+
+  // Zero digits stay in place, the sum of the infinite tail of zeros is zero.
+  for (uint32_t base : bases_) {
+    const size_t offset = permutations_.size();
+    offsets_.push_back(offset);
+
+    for (uint32_t digit = 0; digit < base; digit++) {
+      permutations_.push_back(static_cast<uint16_t>(digit));
+    }
+    for (uint32_t i = base - 1; i > 1; i--) {
+      const uint32_t j = 1 + rng.NextInt(static_cast<int>(i));
+      std::swap(permutations_[offset + i], permutations_[offset + j]);
+    }
+  }
+}
+
+void HaltonEngine::Next(double* out, size_t stride) {
+  const bool scrambled = !permutations_.empty();
+
+  for (size_t d = 0; d < bases_.size(); d++) {
+    const uint32_t base = bases_[d];
+    const double inverse = 1.0 / base;
+
+    double factor = inverse;
+    double result = 0;
+    for (uint64_t n = index_; n != 0; n /= base) {
+      const uint32_t digit = static_cast<uint32_t>(n % base);
+      result += (scrambled ? permutations_[offsets_[d] + digit] : digit) * factor;
+      factor *= inverse;
+    }
+
+    out[d * stride] = result;
+  }
+
+  index_++;
+}
+
+template <typename Engine>
+Napi::Object QuasiRandom<Engine>::Init(Napi::Env env, Napi::Object exports) {
+  using Wrap = Napi::ObjectWrap<QuasiRandom<Engine>>;
+
+  Napi::Function func =
+      Wrap::DefineClass(env,
+                        Engine::kName, {
+                        Wrap::InstanceMethod("dimensions", &QuasiRandom::Dimensions),
+                        Wrap::InstanceMethod("index",      &QuasiRandom::Index),
+                        Wrap::InstanceMethod("skip",       &QuasiRandom::Skip),
+                        Wrap::InstanceMethod("fill",       &QuasiRandom::Fill)});
+
+  exports.Set(Engine::kName, func);
+
+  return exports;
+}
+
+template <typename Engine>
+QuasiRandom<Engine>::QuasiRandom(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<QuasiRandom<Engine>>(info) {
+  Napi::Env env = info.Env();
+
+  if (!info.Length() || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+    return;
+  }
+
+  const int64_t dimensions = info[0].As<Napi::Number>().Int64Value();
+  if (dimensions < 1 || static_cast<uint64_t>(dimensions) > Engine::kMaxDimensions) {
+    Napi::RangeError::New(env, "Dimensions out of range").ThrowAsJavaScriptException();
+    return;
+  }
+
+  // Scrambling is all that is needed from the generator.
+  RandomSource source;
+  if (!source.Init(env, info[1])) {
+    return;
+  }
+
+  const bool scramble = info.Length() > 2 && info[2].ToBoolean().Value();
+
+  this->engine_.Init(static_cast<size_t>(dimensions), source.rng(), scramble);
+}
+
+template <typename Engine>
+Napi::Value QuasiRandom<Engine>::Dimensions(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), static_cast<double>(this->engine_.dimensions()));
+}
+
+template <typename Engine>
+Napi::Value QuasiRandom<Engine>::Index(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), static_cast<double>(this->engine_.index()));
+}
+
+// Jumps n points ahead, so that workers can take disjoint ranges.
+template <typename Engine>
+void QuasiRandom<Engine>::Skip(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!info.Length() || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+    return;
+  }
+
+  const int64_t n = info[0].As<Napi::Number>().Int64Value();
+  if (n < 0 || static_cast<uint64_t>(n) > Engine::kMaxPoints - this->engine_.index()) {
+    Napi::RangeError::New(env, "Skip out of range").ThrowAsJavaScriptException();
+    return;
+  }
+
+  this->engine_.Seek(this->engine_.index() + n);
+}
+
+// fill(out, count[, columnMajor]) writes count points to out: point i,
+// dimension d goes to out[i * dimensions + d], or to out[d * count + i] in
+// column-major layout.
+template <typename Engine>
+Napi::Value QuasiRandom<Engine>::Fill(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 ||
+      !info[0].IsTypedArray() || info[0].As<Napi::TypedArray>().TypedArrayType() != napi_float64_array ||
+      !info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Expected fill(Float64Array, count[, columnMajor])").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Float64Array out = info[0].As<Napi::Float64Array>();
+  const int64_t count = info[1].As<Napi::Number>().Int64Value();
+  const size_t dimensions = this->engine_.dimensions();
+
+  if (count < 0 || static_cast<uint64_t>(count) > out.ElementLength() / dimensions) {
+    Napi::RangeError::New(env, "Output is too short").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  if (static_cast<uint64_t>(count) > Engine::kMaxPoints - this->engine_.index()) {
+    Napi::RangeError::New(env, "Sequence exhausted").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  const bool column_major = info.Length() > 2 && info[2].ToBoolean().Value();
+  double* data = out.Data();
+
+  for (int64_t i = 0; i < count; i++) {
+    if (column_major) {
+      this->engine_.Next(data + i, count);
+    } else {
+      this->engine_.Next(data + i * dimensions, 1);
+    }
+  }
+
+  return out;
+}
+
+template class QuasiRandom<SobolEngine>;
+template class QuasiRandom<HaltonEngine>;
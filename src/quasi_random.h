@@ -0,0 +1,88 @@
+#ifndef QUASI_RANDOM_H
+#define QUASI_RANDOM_H
+
+#include <napi.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "utils/random-number-generator.h"
+
+// Sobol sequence in Gray code order with 32-bit direction numbers. Dimension 1
+// is van der Corput, dimension d > 1 uses the (d - 1)-th primitive polynomial
+// over GF(2) (by degree, then value) and the initial direction numbers of Joe
+// and Kuo (new-joe-kuo-6.21201), as most other Sobol implementations do.
+// Scrambling is hash-based nested uniform (Owen) scrambling, see Burley,
+// "Practical Hash-based Owen Scrambling", 2020.
+class SobolEngine {
+ public:
+  static constexpr const char* kName = "Sobol";
+  static constexpr size_t kMaxDimensions = 1111;
+  static constexpr uint64_t kMaxPoints = uint64_t{1} << 32;
+
+  void Init(size_t dimensions, v8::base::RandomNumberGenerator& rng, bool scramble);
+
+  size_t dimensions() const { return dimensions_; }
+  uint64_t index() const { return index_; }
+
+  void Seek(uint64_t index);
+
+  // Writes the point at index() to out[0], out[stride], ... and moves on.
+  void Next(double* out, size_t stride);
+
+ private:
+  static constexpr int kBits = 32;
+
+  size_t dimensions_ = 0;
+  uint64_t index_ = 0;
+  std::vector<uint32_t> directions_;  // kBits per dimension
+  std::vector<uint32_t> seeds_;       // scrambling, empty if not scrambled
+  std::vector<uint32_t> x_;           // point at index_ before scrambling
+};
+
+// Halton sequence, dimension d uses the d-th prime as a base. Scrambling
+// applies a random permutation of non-zero digits per base.
+class HaltonEngine {
+ public:
+  static constexpr const char* kName = "Halton";
+  static constexpr size_t kMaxDimensions = 1111;
+  static constexpr uint64_t kMaxPoints = uint64_t{1} << 53;
+
+  void Init(size_t dimensions, v8::base::RandomNumberGenerator& rng, bool scramble);
+
+  size_t dimensions() const { return bases_.size(); }
+  uint64_t index() const { return index_; }
+
+  void Seek(uint64_t index) { index_ = index; }
+
+  void Next(double* out, size_t stride);
+
+ private:
+  uint64_t index_ = 0;
+  std::vector<uint32_t> bases_;
+  std::vector<size_t> offsets_;        // of base digits in permutations_
+  std::vector<uint16_t> permutations_; // empty if not scrambled
+};
+
+// Object that generates low-discrepancy points: new Sobol(dimensions[, prng[,
+// scramble]]) and new Halton(...) with the same methods.
+template <typename Engine>
+class QuasiRandom : public Napi::ObjectWrap<QuasiRandom<Engine>> {
+ public:
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+  QuasiRandom(const Napi::CallbackInfo& info);
+
+ private:
+  Napi::Value Dimensions(const Napi::CallbackInfo& info);
+  Napi::Value Index(const Napi::CallbackInfo& info);
+  void Skip(const Napi::CallbackInfo& info);
+  Napi::Value Fill(const Napi::CallbackInfo& info);
+
+  Engine engine_;
+};
+
+using Sobol = QuasiRandom<SobolEngine>;
+using Halton = QuasiRandom<HaltonEngine>;
+
+#endif
@@ -0,0 +1,163 @@
+#include "random_stream.h"
+
+#include <limits>
+#include <new>
+
+#include <openssl/rand.h>
+
+static constexpr size_t kPoolSize = 4;
+
+BlockPool::~BlockPool() {
+  for (char* block : free_) {
+    delete[] block;
+  }
+}
+
+char* BlockPool::Get() {
+  if (!free_.empty()) {
+    char* block = free_.back();
+    free_.pop_back();
+    return block;
+  }
+
+  return new (std::nothrow) char[block_size_];
+}
+
+void BlockPool::Put(char* block) {
+  if (free_.size() < max_free_) {
+    free_.push_back(block);
+    return;
+  }
+
+  delete[] block;
+}
+
+class FillWorker : public Napi::AsyncWorker {
+ public:
+  FillWorker(const Napi::Function& callback, ByteSource* source, char* block)
+      : Napi::AsyncWorker(callback),
+        source_(source), self_(Napi::Persistent(source->Value())), block_(block) {}
+
+ protected:
+  void Execute() override {
+    if (!this->source_->Fill(this->block_)) {
+      SetError("RAND_bytes failed");
+    }
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+
+    this->source_->busy_ = false;
+    Napi::Value chunk = this->source_->Wrap(env, this->block_);
+    Callback().MakeCallback(Receiver().Value(), { env.Null(), chunk });
+  }
+
+  void OnError(const Napi::Error& e) override {
+    this->source_->busy_ = false;
+    this->source_->pool_->Put(this->block_);
+    Callback().MakeCallback(Receiver().Value(), { e.Value() });
+  }
+
+ private:
+  ByteSource* source_;
+  Napi::ObjectReference self_;
+  char* block_;
+};
+
+Napi::Object ByteSource::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func =
+      DefineClass(env,
+                  "ByteSource", {
+                  InstanceMethod("read", &ByteSource::Read)});
+
+  exports.Set("ByteSource", func);
+
+  return exports;
+}
+
+ByteSource::ByteSource(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<ByteSource>(info) {
+  Napi::Env env = info.Env();
+
+  if (!info.Length() || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+    return;
+  }
+
+  const int64_t chunk_size = info[0].As<Napi::Number>().Int64Value();
+  if (chunk_size < 1 || chunk_size > std::numeric_limits<int>::max()) {
+    Napi::RangeError::New(env, "Chunk size out of range").ThrowAsJavaScriptException();
+    return;
+  }
+
+  this->secure_ = info.Length() > 2 && info[2].ToBoolean().Value();
+
+  // Chunks are generated off the main thread, so a given PRNG only seeds the
+  // own generator, and stays usable meanwhile. Secure chunks don't need one,
+  // and the PRNG is left alone.
+  if (!this->secure_) {
+    RandomSource source;
+    if (!source.Init(env, info[1])) {
+      return;
+    }
+    this->rng_.SetSeed(source.rng().NextInt64());
+    this->from_entropy_ = source.from_entropy();
+  }
+
+  this->pool_ = std::make_shared<BlockPool>(static_cast<size_t>(chunk_size), kPoolSize);
+}
+
+bool ByteSource::Fill(char* block) {
+  const size_t size = this->pool_->block_size();
+
+  if (this->secure_) {
+    return RAND_bytes(reinterpret_cast<unsigned char*>(block), static_cast<int>(size)) == 1;
+  }
+
+  this->rng_.FillBytes(block, size);
+  return true;
+}
+
+// The Buffer owns a reference to the pool, which may outlive the source.
+Napi::Value ByteSource::Wrap(Napi::Env env, char* block) {
+  return Napi::Buffer<char>::New(
+      env, block, this->pool_->block_size(),
+      [](Napi::Env env, char* data, std::shared_ptr<BlockPool>* pool) {
+        (*pool)->Put(data);
+        delete pool;
+      },
+      new std::shared_ptr<BlockPool>(this->pool_));
+}
+
+// read(callback) fills the next chunk on the threadpool and calls back with
+// (err, buffer).
+Napi::Value ByteSource::Read(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!info.Length() || !info[0].IsFunction()) {
+    Napi::TypeError::New(env, "Function expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  if (this->busy_) {
+    Napi::Error::New(env, "Read already in progress").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  char* block = this->pool_->Get();
+  if (block == nullptr) {
+    Napi::Error::New(env, "Out of memory").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  // No fill is running, so the generator can be touched here.
+  if (this->fork_.Forked() && this->from_entropy_) {
+    this->rng_.Reseed();
+  }
+
+  this->busy_ = true;
+  (new FillWorker(info[0].As<Napi::Function>(), this, block))->Queue();
+
+  return env.Undefined();
+}
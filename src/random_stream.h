@@ -0,0 +1,64 @@
+#ifndef RANDOM_STREAM_H
+#define RANDOM_STREAM_H
+
+#include <napi.h>
+
+#include <memory>
+#include <vector>
+
+#include "prng.h"
+#include "utils/random-number-generator.h"
+
+// Fixed size blocks recycled through the finalizers of the external Buffers
+// handed out to JS. Touched on the main thread only.
+class BlockPool {
+ public:
+  BlockPool(size_t block_size, size_t max_free)
+      : block_size_(block_size), max_free_(max_free) {}
+  ~BlockPool();
+
+  size_t block_size() const { return block_size_; }
+
+  // Returns nullptr if out of memory.
+  char* Get();
+  void Put(char* block);
+
+ private:
+  const size_t block_size_;
+  const size_t max_free_;
+  std::vector<char*> free_;
+};
+
+// Native side of seeder.createRandomStream(): new ByteSource(chunkSize, prng,
+// secure) hands out chunks of random bytes as external Buffers, filled on the
+// threadpool by read(callback). Chunks come either from OpenSSL RAND_bytes()
+// (secure) or from an own generator seeded by the prng argument, which is
+// never touched off the main thread.
+class ByteSource : public Napi::ObjectWrap<ByteSource> {
+ public:
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+  ByteSource(const Napi::CallbackInfo& info);
+
+ private:
+  friend class FillWorker;
+
+  Napi::Value Read(const Napi::CallbackInfo& info);
+
+  // Returns false if RAND_bytes() failed.
+  bool Fill(char* block);
+  Napi::Value Wrap(Napi::Env env, char* block);
+
+  std::shared_ptr<BlockPool> pool_;
+  v8::base::RandomNumberGenerator rng_;
+  bool secure_ = false;
+
+  // A generator seeded from the entropy source reseeds in a forked child.
+  bool from_entropy_ = false;
+  ForkWatch fork_;
+
+  // One fill at a time, the generator is not threadsafe.
+  bool busy_ = false;
+};
+
+#endif
@@ -0,0 +1,213 @@
+#include "replay_log.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "utils/macros.h"
+
+static constexpr size_t kInitialCapacity = 1 << 20;
+
+constexpr char ReplayLog::kMagic[8];
+
+ReplayLog::~ReplayLog() {
+  Close();
+}
+
+bool ReplayLog::Fail(const char* what) {
+  error_ = std::string(what) + ": " + strerror(errno);
+  failed_ = true;
+  return false;
+}
+
+bool ReplayLog::Map(size_t size, bool writable) {
+  const int prot = PROT_READ | (writable ? PROT_WRITE : 0);
+
+  void* data = mmap(nullptr, size, prot, MAP_SHARED, fd_, 0);
+  if (data == MAP_FAILED) {
+    return Fail("mmap");
+  }
+
+  data_ = static_cast<char*>(data);
+  capacity_ = size;
+  return true;
+}
+
+void ReplayLog::Unmap() {
+  if (data_ != nullptr) {
+    munmap(data_, capacity_);
+    data_ = nullptr;
+  }
+  capacity_ = 0;
+}
+
+bool ReplayLog::OpenForRecording(const std::string& path,
+                                 const v8::base::RandomNumberGenerator& rng,
+                                 uint64_t interval) {
+  fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    return Fail("open");
+  }
+
+  recording_ = true;
+  interval_ = interval;
+
+  const size_t capacity = std::max(kInitialCapacity, CheckpointOffset(1));
+  if (ftruncate(fd_, capacity) != 0) {
+    return Fail("ftruncate");
+  }
+  if (!Map(capacity, true)) {
+    return false;
+  }
+
+  Header* header = reinterpret_cast<Header*>(data_);
+  memcpy(header->magic, kMagic, sizeof(kMagic));
+  header->version = kVersion;
+  header->engine = kEngineXorShift128;
+  header->seed = rng.initial_seed();
+  header->interval = interval_;
+  header->draws = 0;
+
+  return NextBlock(rng);
+}
+
+bool ReplayLog::OpenForReplay(const std::string& path) {
+  fd_ = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd_ < 0) {
+    return Fail("open");
+  }
+
+  struct stat st;
+  if (fstat(fd_, &st) != 0) {
+    return Fail("fstat");
+  }
+
+  errno = EINVAL;
+  if (static_cast<size_t>(st.st_size) < sizeof(Header)) {
+    return Fail("not a replay log");
+  }
+  if (!Map(st.st_size, false)) {
+    return false;
+  }
+
+  const Header* header = reinterpret_cast<const Header*>(data_);
+  errno = EINVAL;
+  if (memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kVersion) {
+    return Fail("not a replay log");
+  }
+  if (header->engine != kEngineXorShift128) {
+    return Fail("unknown engine");
+  }
+  if (header->interval == 0) {
+    return Fail("corrupted replay log");
+  }
+
+  // Offsets are only computed for draws that fit into the file, so a bogus
+  // interval or count can't make them wrap around.
+  if (header->interval > (SIZE_MAX - 2 * sizeof(uint64_t)) / sizeof(double)) {
+    return Fail("corrupted replay log");
+  }
+
+  interval_ = header->interval;
+
+  const size_t size = capacity_ - sizeof(Header);
+  if (size < 2 * sizeof(uint64_t)) {
+    return Fail("truncated replay log");
+  }
+
+  const uint64_t blocks = size / BlockSize();
+  const size_t rest = size % BlockSize();
+  const uint64_t draws = blocks * interval_ +
+                         (rest < 2 * sizeof(uint64_t) ? 0 : (rest - 2 * sizeof(uint64_t)) / sizeof(double));
+  if (header->draws > draws) {
+    return Fail("truncated replay log");
+  }
+
+  draws_ = header->draws;
+  return true;
+}
+
+bool ReplayLog::Close() {
+  if (fd_ < 0) {
+    return !failed_;
+  }
+
+  bool ok = !failed_;
+
+  if (recording_ && data_ != nullptr) {
+    reinterpret_cast<Header*>(data_)->draws = draws_;
+  }
+
+  Unmap();
+
+  if (recording_) {
+    if (ftruncate(fd_, Size()) != 0) {
+      ok = Fail("ftruncate");
+    }
+  }
+
+  close(fd_);
+  fd_ = -1;
+  recording_ = false;
+  return ok;
+}
+
+bool ReplayLog::Grow(size_t size) {
+  const size_t capacity = std::max(capacity_ * 2, size);
+
+  Unmap();
+  if (ftruncate(fd_, capacity) != 0) {
+    return Fail("ftruncate");
+  }
+
+  return Map(capacity, true);
+}
+
+bool ReplayLog::NextBlock(const v8::base::RandomNumberGenerator& rng) {
+  if (failed_) {
+    return false;
+  }
+
+  reinterpret_cast<Header*>(data_)->draws = draws_;
+
+  const uint64_t block = position_ / interval_;
+  if (CheckpointOffset(block + 1) > capacity_ && !Grow(CheckpointOffset(block + 1))) {
+    return false;
+  }
+
+  uint64_t* state = reinterpret_cast<uint64_t*>(data_ + CheckpointOffset(block));
+  state[0] = rng.state0();
+  state[1] = rng.state1();
+
+  cursor_ = reinterpret_cast<double*>(state + 2);
+  block_left_ = interval_;
+  return true;
+}
+
+bool ReplayLog::Seek(uint64_t i) {
+  if (i > draws_) {
+    return false;
+  }
+
+  position_ = i;
+  block_left_ = 0;
+  return true;
+}
+
+void ReplayLog::Restore(v8::base::RandomNumberGenerator& rng) const {
+  const uint64_t blocks = draws_ == 0 ? 1 : (draws_ - 1) / interval_ + 1;
+  const uint64_t block = std::min(position_ / interval_, blocks - 1);
+
+  const uint64_t* state = reinterpret_cast<const uint64_t*>(data_ + CheckpointOffset(block));
+  rng.SetState(state[0], state[1]);
+
+  for (uint64_t i = block * interval_; i < position_; i++) {
+    USE(rng.NextDouble());
+  }
+}
@@ -0,0 +1,137 @@
+#ifndef REPLAY_LOG_H
+#define REPLAY_LOG_H
+
+#include <cstdint>
+#include <string>
+
+#include "utils/random-number-generator.h"
+
+// Memory-mapped log of PRNG draws.
+//
+//     header    64 bytes, see ReplayLog::Header
+//     block 0   state0, state1 (uint64) before its first draw, then up to
+//               `interval` draws (double)
+//     block 1   ...
+//
+// Every block but the last one is full, so draw i is found at a fixed offset
+// and the checkpoints let the generator resume from any point of the log.
+class ReplayLog {
+ public:
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t engine;
+    int64_t seed;
+    uint64_t interval;
+    uint64_t draws;
+    uint64_t reserved[3];
+  };
+
+  static constexpr char kMagic[8] = { 'N', 'R', 'S', 'D', 'L', 'O', 'G', '1' };
+  static constexpr uint32_t kVersion = 1;
+  // xorshift128+ with RandomNumberGenerator::ToDouble().
+  static constexpr uint32_t kEngineXorShift128 = 1;
+
+  ReplayLog() = default;
+  ~ReplayLog();
+
+  ReplayLog(const ReplayLog&) = delete;
+  ReplayLog& operator=(const ReplayLog&) = delete;
+
+  // Creates the log, the first checkpoint is the current state of rng.
+  bool OpenForRecording(const std::string& path, const v8::base::RandomNumberGenerator& rng,
+                        uint64_t interval);
+  bool OpenForReplay(const std::string& path);
+
+  // Finalizes a recording. Returns false if the file couldn't be truncated.
+  bool Close();
+
+  bool recording() const { return recording_; }
+  const std::string& error() const { return error_; }
+
+  uint64_t draws() const { return draws_; }
+  uint64_t position() const { return position_; }
+
+  // Draws from rng, recording it, costs a store on the fast path. Returns
+  // false without drawing when the log can't grow, see error().
+  bool Record(v8::base::RandomNumberGenerator& rng, double* num) {
+    if (block_left_ == 0 && !NextBlock(rng)) {
+      return false;
+    }
+
+    *num = rng.NextDouble();
+    *cursor_++ = *num;
+    block_left_--;
+    draws_ = ++position_;
+    return true;
+  }
+
+  // Returns false when the log has no more draws.
+  bool Replay(double* num) {
+    if (position_ >= draws_) {
+      return false;
+    }
+
+    if (block_left_ == 0) {
+      cursor_ = reinterpret_cast<double*>(data_ + Offset(position_));
+      block_left_ = interval_ - position_ % interval_;
+    }
+
+    *num = *cursor_++;
+    block_left_--;
+    position_++;
+    return true;
+  }
+
+  // Moves replay to draw i <= draws().
+  bool Seek(uint64_t i);
+
+  // Puts rng into the state it had before the draw at position().
+  void Restore(v8::base::RandomNumberGenerator& rng) const;
+
+ private:
+  size_t BlockSize() const { return 2 * sizeof(uint64_t) + interval_ * sizeof(double); }
+
+  size_t Offset(uint64_t i) const {
+    return sizeof(Header) + (i / interval_) * BlockSize() + 2 * sizeof(uint64_t) +
+           (i % interval_) * sizeof(double);
+  }
+
+  size_t CheckpointOffset(uint64_t block) const {
+    return sizeof(Header) + block * BlockSize();
+  }
+
+  // Size of the file holding draws().
+  size_t Size() const {
+    return draws_ == 0 ? CheckpointOffset(0) + 2 * sizeof(uint64_t)
+                       : Offset(draws_ - 1) + sizeof(double);
+  }
+
+  // Starts the block of position(), with rng state as its checkpoint. The
+  // header is brought up to date first, so a crashed recording is readable
+  // up to the last checkpoint.
+  bool NextBlock(const v8::base::RandomNumberGenerator& rng);
+  bool Grow(size_t size);
+  bool Map(size_t size, bool writable);
+  void Unmap();
+  // Records the error, recording stops there but the log stays valid.
+  bool Fail(const char* what);
+
+  int fd_ = -1;
+  char* data_ = nullptr;
+  size_t capacity_ = 0;
+  bool recording_ = false;
+  bool failed_ = false;
+
+  uint64_t interval_ = 1;
+  uint64_t draws_ = 0;
+  uint64_t position_ = 0;
+
+  // Next draw of the current block and the number of draws left in it.
+  double* cursor_ = nullptr;
+  uint64_t block_left_ = 0;
+
+  std::string error_;
+};
+
+#endif
@@ -0,0 +1,224 @@
+#include "reservoir.h"
+
+#include <cmath>
+#include <limits>
+#include <utility>
+
+Napi::Object Reservoir::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func =
+      DefineClass(env,
+                  "Reservoir", {
+                  InstanceMethod("add",    &Reservoir::Add),
+                  InstanceMethod("sample", &Reservoir::Sample),
+                  InstanceMethod("count",  &Reservoir::Count)});
+
+  exports.Set("Reservoir", func);
+
+  return exports;
+}
+
+Reservoir::Reservoir(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<Reservoir>(info) {
+  Napi::Env env = info.Env();
+
+  if (!info.Length() || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+    return;
+  }
+
+  const int64_t k = info[0].As<Napi::Number>().Int64Value();
+  if (k < 1 || k > std::numeric_limits<int>::max()) {
+    Napi::RangeError::New(env, "Sample size out of range").ThrowAsJavaScriptException();
+    return;
+  }
+
+  if (!this->source_.Init(env, info[1])) {
+    return;
+  }
+
+  Napi::ArrayBuffer buffer = Napi::ArrayBuffer::New(env, k * sizeof(uint32_t));
+  this->buffer_ = Napi::Persistent(buffer);
+  this->ids_ = static_cast<uint32_t*>(buffer.Data());
+  this->k_ = static_cast<size_t>(k);
+}
+
+void Reservoir::Add(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!info.Length() || !info[0].IsTypedArray() ||
+      info[0].As<Napi::TypedArray>().TypedArrayType() != napi_uint32_array) {
+    Napi::TypeError::New(env, "Uint32Array expected").ThrowAsJavaScriptException();
+    return;
+  }
+
+  Napi::Uint32Array ids = info[0].As<Napi::Uint32Array>();
+  const bool weighted = info.Length() > 1 && !info[1].IsUndefined();
+  const Mode mode = weighted ? Mode::kWeighted : Mode::kUniform;
+
+  if (this->mode_ != Mode::kUnset && this->mode_ != mode) {
+    Napi::TypeError::New(env, "Cannot mix weighted and uniform chunks").ThrowAsJavaScriptException();
+    return;
+  }
+
+  if (!weighted) {
+    this->mode_ = mode;
+    AddUniform(ids.Data(), ids.ElementLength());
+    return;
+  }
+
+  if (!info[1].IsTypedArray() ||
+      info[1].As<Napi::TypedArray>().TypedArrayType() != napi_float64_array) {
+    Napi::TypeError::New(env, "Float64Array expected").ThrowAsJavaScriptException();
+    return;
+  }
+
+  Napi::Float64Array weights = info[1].As<Napi::Float64Array>();
+  if (weights.ElementLength() != ids.ElementLength()) {
+    Napi::RangeError::New(env, "Ids and weights lengths differ").ThrowAsJavaScriptException();
+    return;
+  }
+
+  const double* w = weights.Data();
+  for (size_t i = 0; i < weights.ElementLength(); i++) {
+    if (!(w[i] >= 0) || !std::isfinite(w[i])) {
+      Napi::RangeError::New(env, "Weights must be finite and non-negative").ThrowAsJavaScriptException();
+      return;
+    }
+  }
+
+  this->mode_ = mode;
+  AddWeighted(ids.Data(), w, ids.ElementLength());
+}
+
+// sample() returns a view of the reservoir itself, no copy per call. Later
+// add() calls replace ids in it, and its length stays the sample size at the
+// time of the call. Weighted ids are in heap order, parallel to keys_, so
+// writes through the view corrupt the sample.
+Napi::Value Reservoir::Sample(const Napi::CallbackInfo& info) {
+  return Napi::Uint32Array::New(info.Env(), this->size_, this->buffer_.Value(), 0, napi_uint32_array);
+}
+
+Napi::Value Reservoir::Count(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), static_cast<double>(this->count_));
+}
+
+void Reservoir::SkipUniform() {
+  const double skip = std::floor(std::log(NextOpenDouble()) / std::log1p(-this->w_));
+
+  // W may get so small that no item of any realistic stream is taken anymore.
+  if (!(skip < static_cast<double>(std::numeric_limits<uint64_t>::max() - this->next_))) {
+    this->next_ = std::numeric_limits<uint64_t>::max();
+    return;
+  }
+
+  this->next_ += static_cast<uint64_t>(skip) + 1;
+}
+
+void Reservoir::AddUniform(const uint32_t* ids, size_t length) {
+  size_t i = 0;
+
+  while (this->size_ < this->k_ && i < length) {
+    this->ids_[this->size_++] = ids[i++];
+    this->count_++;
+
+    if (this->size_ == this->k_) {
+      this->w_ = std::exp(std::log(NextOpenDouble()) / this->k_);
+      this->next_ = this->count_ - 1;
+      SkipUniform();
+    }
+  }
+
+  if (this->size_ < this->k_) {
+    return;
+  }
+
+  const uint64_t end = this->count_ + (length - i);
+  while (this->next_ < end) {
+    const int slot = this->source_.rng().NextInt(static_cast<int>(this->k_));
+    this->ids_[slot] = ids[i + (this->next_ - this->count_)];
+    this->w_ *= std::exp(std::log(NextOpenDouble()) / this->k_);
+    SkipUniform();
+  }
+
+  this->count_ = end;
+}
+
+void Reservoir::SkipWeighted() {
+  const double threshold = this->keys_[0];
+
+  // Keys are log(u) / w <= 0, the zero key cannot be beaten.
+  this->skip_ = threshold < 0
+      ? std::log(NextOpenDouble()) / threshold
+      : std::numeric_limits<double>::infinity();
+}
+
+void Reservoir::AddWeighted(const uint32_t* ids, const double* weights, size_t length) {
+  size_t i = 0;
+
+  for (; this->size_ < this->k_ && i < length; i++) {
+    if (weights[i] == 0) {
+      continue;
+    }
+
+    this->ids_[this->size_] = ids[i];
+    this->keys_.push_back(std::log(NextOpenDouble()) / weights[i]);
+    SiftUp(this->size_++);
+
+    if (this->size_ == this->k_) {
+      SkipWeighted();
+    }
+  }
+
+  for (; i < length; i++) {
+    this->skip_ -= weights[i];
+    if (this->skip_ > 0 || weights[i] == 0) {
+      continue;
+    }
+
+    // The new key is drawn conditioned on beating the current minimum.
+    const double t = std::exp(this->keys_[0] * weights[i]);
+    const double r = t + (1 - t) * NextOpenDouble();
+
+    this->ids_[0] = ids[i];
+    this->keys_[0] = std::log(r) / weights[i];
+    SiftDown(0);
+    SkipWeighted();
+  }
+
+  this->count_ += length;
+}
+
+void Reservoir::SiftUp(size_t i) {
+  while (i > 0) {
+    const size_t parent = (i - 1) / 2;
+    if (this->keys_[parent] <= this->keys_[i]) {
+      break;
+    }
+
+    std::swap(this->keys_[parent], this->keys_[i]);
+    std::swap(this->ids_[parent], this->ids_[i]);
+    i = parent;
+  }
+}
+
+void Reservoir::SiftDown(size_t i) {
+  while (true) {
+    const size_t l = 2 * i + 1;
+    const size_t r = l + 1;
+
+    size_t min = i;
+    if (l < this->size_ && this->keys_[l] < this->keys_[min]) {
+      min = l;
+    }
+    if (r < this->size_ && this->keys_[r] < this->keys_[min]) {
+      min = r;
+    }
+    if (min == i) {
+      break;
+    }
+
+    std::swap(this->keys_[min], this->keys_[i]);
+    std::swap(this->ids_[min], this->ids_[i]);
+    i = min;
+  }
+}
@@ -0,0 +1,62 @@
+#ifndef RESERVOIR_H
+#define RESERVOIR_H
+
+#include <napi.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "prng.h"
+
+// Object that keeps a random sample of k ids out of a stream consumed in
+// chunks. Uniform streams use Li's Algorithm L, weighted streams use
+// Efraimidis-Spirakis A-ExpJ. Both jump over the items that cannot enter the
+// sample, so only O(k log(N/k)) random numbers are drawn for N items.
+class Reservoir : public Napi::ObjectWrap<Reservoir> {
+ public:
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+  Reservoir(const Napi::CallbackInfo& info);
+
+ private:
+  enum class Mode { kUnset, kUniform, kWeighted };
+
+  void Add(const Napi::CallbackInfo& info);
+  Napi::Value Sample(const Napi::CallbackInfo& info);
+  Napi::Value Count(const Napi::CallbackInfo& info);
+
+  void AddUniform(const uint32_t* ids, size_t length);
+  void AddWeighted(const uint32_t* ids, const double* weights, size_t length);
+
+  // Uniform number in (0, 1].
+  double NextOpenDouble() { return 1 - this->source_.rng().NextDouble(); }
+
+  void SkipUniform();
+  void SkipWeighted();
+
+  void SiftUp(size_t i);
+  void SiftDown(size_t i);
+
+  RandomSource source_;
+  Mode mode_ = Mode::kUnset;
+
+  // Sample ids live in a JS owned buffer, so sample() returns a view of it.
+  Napi::Reference<Napi::ArrayBuffer> buffer_;
+  uint32_t* ids_ = nullptr;
+  size_t k_ = 0;
+  size_t size_ = 0;
+
+  // Number of items seen so far.
+  uint64_t count_ = 0;
+
+  // Algorithm L: index of the next item to take and the current W.
+  uint64_t next_ = 0;
+  double w_ = 0;
+
+  // A-ExpJ: min-heap of log(u) / weight keys parallel to ids_, and the weight
+  // left to skip before the next replacement.
+  std::vector<double> keys_;
+  double skip_ = 0;
+};
+
+#endif
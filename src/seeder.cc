@@ -1,7 +1,6 @@
 #include <napi.h>
 #include <node.h>
 
-#include <array>
 #include <chrono>
 #include <string>
 #include <sstream>
@@ -9,42 +8,38 @@
 #include <sys/wait.h>
 #include <unistd.h>
 
-#include <openssl/rand.h>
-
+#include "nreseed.h"
 #include "prng.h"
+#include "weighted_sampler.h"
+#include "reservoir.h"
+#include "prng_pool.h"
+#include "threadpool_reseed.h"
+#include "permutation.h"
+#include "quasi_random.h"
+#include "random_stream.h"
+#include "discrete.h"
+#include "bernoulli.h"
+#include "shared_streams.h"
 
 #include "utils/time.h"
-#include "utils/bit_cast.h"
-
-// This one covers OpenSSL RAND/EVP/ossl_prov_drbg_generate,
-// or reseeds Node.js's Crypto.getRandomBytes()/node::crypto::CSPRNG.
-//
-//     #0  0x0000000001b99354 in ossl_prov_drbg_generate ()
-//     #1  0x0000000001a83969 in evp_rand_generate_locked ()
-//     #2  0x0000000001a84859 in EVP_RAND_generate ()
-//     #3  0x0000000001aeda44 in RAND_bytes ()
-//     #4  0x0000000000d7ea96 in node::crypto::CSPRNG(void*, unsigned long) ()
-//
-// however, see https://wiki.openssl.org/index.php/Random_fork-safety.
-void Reseed_OpenSSL_RAND(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
-
-  EVP_RAND_CTX *drbg = RAND_get0_primary(NULL);
-  if (drbg == NULL) {
-    Napi::TypeError::New(env, "no primary EVP_RAND_CTX found").ThrowAsJavaScriptException();
-    return;
-  }
 
-  int64_t addin = v8::base::NowFromSystemTime() << 24;
-  addin ^= v8::base::TimeTicksNow();
-
-  // We don't have any entropy data here, so kindly ask OpenSSL impl to get
-  // us some. We could perform RAND_seed(getpid()) as it is advertised in
-  // Random_fork-satefy, but in PID namespaces all processes will be having
-  // the same pid_t with very high probability (around pid_t == 1).
-  auto addin_buf = v8::base::bit_cast<std::array<unsigned char, 8>>(addin);
-  if (!EVP_RAND_reseed(drbg, 0, NULL, 0, addin_buf.data(), 8)) {
+// Converts libnreseed status into a JS exception, returns true if thrown.
+bool ThrowOnError(Napi::Env env, int result) {
+  switch (result) {
+  case NRESEED_OK:
+    return false;
+  case NRESEED_ENODRBG:
+    Napi::TypeError::New(env, "no EVP_RAND_CTX found").ThrowAsJavaScriptException();
+    return true;
+  case NRESEED_ERESEED:
     Napi::TypeError::New(env, "EVP_RAND_reseed failed").ThrowAsJavaScriptException();
+    return true;
+  case NRESEED_EATFORK:
+    Napi::Error::New(env, "pthread_atfork() failed").ThrowAsJavaScriptException();
+    return true;
+  default:
+    Napi::Error::New(env, "nreseed failed").ThrowAsJavaScriptException();
+    return true;
   }
 }
 
@@ -64,11 +59,21 @@ void Reseed_Math_RAND(const Napi::CallbackInfo& info) {
   v8::V8::SetFlagsFromString(s.c_str());
 }
 
+// Reseeds OpenSSL and everything registered in libnreseed, including
+// generators of other native addons linked against it.
 void Reseed(const Napi::CallbackInfo& info) {
-  Reseed_OpenSSL_RAND(info);
+  ThrowOnError(info.Env(), nreseed_reseed_all());
   Reseed_Math_RAND(info);
 }
 
+// Makes libnreseed reseed OpenSSL and its registry in every forked child, on
+// the first use of the addon there, and generators seeded from the entropy
+// source on their first draw there (see ForkWatch).
+// The builtin Math.random() is not covered, V8 can not be touched from there.
+void ReseedOnFork(const Napi::CallbackInfo& info) {
+  ThrowOnError(info.Env(), nreseed_install_fork_handler());
+}
+
 
 // fork(2) for test purposes only
 Napi::Value Fork(const Napi::CallbackInfo& info) {
@@ -123,8 +128,28 @@ Napi::Value GetTimeTicksNow(const Napi::CallbackInfo& info) {
 
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
   exports.Set(Napi::String::New(env, "reseed"), Napi::Function::New(env, Reseed));
+  exports.Set(Napi::String::New(env, "reseedOnFork"), Napi::Function::New(env, ReseedOnFork));
+  exports.Set(Napi::String::New(env, "reseedThreadpool"), Napi::Function::New(env, ReseedThreadpool));
+
+  // Live view of the fork count for fastRandom(), polled on every step.
+  uint32_t* forks = const_cast<uint32_t*>(nreseed_fork_generation());
+  Napi::ArrayBuffer forks_buffer = Napi::ArrayBuffer::New(env, forks, sizeof(*forks));
+  exports.Set(Napi::String::New(env, "forkGeneration"),
+              Napi::Uint32Array::New(env, 1, forks_buffer, 0, napi_uint32_array));
 
   PRNG::Init(env, exports);
+  WeightedSampler::Init(env, exports);
+  Reservoir::Init(env, exports);
+  PRNGPool::Init(env, exports);
+  Permutation::Init(env, exports);
+  Sobol::Init(env, exports);
+  Halton::Init(env, exports);
+  ByteSource::Init(env, exports);
+  Poisson::Init(env, exports);
+  Binomial::Init(env, exports);
+  Geometric::Init(env, exports);
+  BernoulliSampler::Init(env, exports);
+  SharedStreams::Init(env, exports);
 
   // internal services for tests
   exports.Set(Napi::String::New(env, "fork"), Napi::Function::New(env, Fork));
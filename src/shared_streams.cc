@@ -0,0 +1,293 @@
+#include "shared_streams.h"
+
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "prng.h"
+
+namespace {
+
+// 128-bit state (state0, state1) as a vector over GF(2).
+struct Vector {
+  uint64_t s0;
+  uint64_t s1;
+};
+
+// Linear map given by the images of the 128 unit vectors, state0 bits first.
+struct Matrix {
+  Vector columns[128];
+};
+
+Vector Apply(const Matrix& m, Vector v) {
+  Vector r = {0, 0};
+  for (int i = 0; i < 64; i++) {
+    if ((v.s0 >> i) & 1) {
+      r.s0 ^= m.columns[i].s0;
+      r.s1 ^= m.columns[i].s1;
+    }
+    if ((v.s1 >> i) & 1) {
+      r.s0 ^= m.columns[64 + i].s0;
+      r.s1 ^= m.columns[64 + i].s1;
+    }
+  }
+  return r;
+}
+
+void Square(Matrix& m) {
+  const Matrix copy = m;
+  for (int i = 0; i < 128; i++) {
+    m.columns[i] = Apply(copy, copy.columns[i]);
+  }
+}
+
+// T^(2^(64 + j)) for j in [0, 64), 128KB computed on first use.
+const std::vector<Matrix>& StreamJumps() {
+  static const std::vector<Matrix> jumps = [] {
+    Matrix m;
+    for (int i = 0; i < 128; i++) {
+      uint64_t s0 = i < 64 ? uint64_t{1} << i : 0;
+      uint64_t s1 = i < 64 ? 0 : uint64_t{1} << (i - 64);
+      v8::base::RandomNumberGenerator::XorShift128(&s0, &s1);
+      m.columns[i] = {s0, s1};
+    }
+
+    for (int k = 0; k < 64; k++) {
+      Square(m);
+    }
+
+    std::vector<Matrix> result(64);
+    for (int j = 0; j < 64; j++) {
+      result[j] = m;
+      Square(m);
+    }
+    return result;
+  }();
+
+  return jumps;
+}
+
+void SleepMillisecond() {
+  struct timespec ts = {0, 1000000};
+  nanosleep(&ts, nullptr);
+}
+
+}  // namespace
+
+void JumpStreams(v8::base::RandomNumberGenerator& rng, uint64_t streams) {
+  const std::vector<Matrix>& jumps = StreamJumps();
+
+  Vector v = {rng.state0(), rng.state1()};
+  for (int j = 0; j < 64; j++) {
+    if ((streams >> j) & 1) {
+      v = Apply(jumps[j], v);
+    }
+  }
+
+  rng.SetState(v.s0, v.s1);
+}
+
+constexpr char SharedStreams::kMagic[8];
+
+Napi::Object SharedStreams::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func =
+      DefineClass(env,
+                  "SharedStreams", {
+                  InstanceMethod("seed",   &SharedStreams::Seed),
+                  InstanceMethod("claim",  &SharedStreams::Claim),
+                  InstanceMethod("select", &SharedStreams::Select),
+                  InstanceMethod("unlink", &SharedStreams::Unlink)});
+
+  exports.Set("SharedStreams", func);
+
+  return exports;
+}
+
+SharedStreams::SharedStreams(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<SharedStreams>(info) {
+  Napi::Env env = info.Env();
+
+  if (!info.Length() || !info[0].IsString()) {
+    Napi::TypeError::New(env, "String expected").ThrowAsJavaScriptException();
+    return;
+  }
+
+  const bool has_seed = info.Length() > 1 && !info[1].IsUndefined();
+  if (has_seed && !info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+    return;
+  }
+
+  // POSIX shared memory names are "/name" without further slashes.
+  const std::string name = info[0].As<Napi::String>().Utf8Value();
+  if (name.empty() || name.size() > 250 || name.find('/') != std::string::npos) {
+    Napi::RangeError::New(env, "Segment name must be 1 to 250 characters without '/'").ThrowAsJavaScriptException();
+    return;
+  }
+
+  this->name_ = "/" + name;
+
+  const int64_t seed = has_seed ? info[1].As<Napi::Number>().Int64Value() : 0;
+  const std::string error = Open(has_seed, seed);
+  if (!error.empty()) {
+    Napi::Error::New(env, error).ThrowAsJavaScriptException();
+    return;
+  }
+}
+
+SharedStreams::~SharedStreams() {
+  if (this->segment_ != nullptr) {
+    munmap(this->segment_, sizeof(Segment));
+  }
+}
+
+std::string SharedStreams::Open(bool has_seed, int64_t seed) {
+  const char* name = this->name_.c_str();
+
+  bool created = true;
+  int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+  if (fd < 0 && errno == EEXIST) {
+    created = false;
+    fd = shm_open(name, O_RDWR | O_CLOEXEC, 0600);
+  }
+  if (fd < 0) {
+    return std::string("shm_open: ") + strerror(errno);
+  }
+
+  if (created) {
+    if (ftruncate(fd, sizeof(Segment)) != 0) {
+      const std::string error = std::string("ftruncate: ") + strerror(errno);
+      close(fd);
+      shm_unlink(name);
+      return error;
+    }
+  } else {
+    // The creator may not have sized the segment yet.
+    struct stat st;
+    st.st_size = 0;
+    int tries = 0;
+    while (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) < sizeof(Segment) && tries++ < 1000) {
+      SleepMillisecond();
+    }
+    if (static_cast<size_t>(st.st_size) < sizeof(Segment)) {
+      close(fd);
+      return "Segment " + this->name_ + " was never initialized";
+    }
+  }
+
+  void* data = mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return std::string("mmap: ") + strerror(errno);
+  }
+
+  Segment* segment = static_cast<Segment*>(data);
+  this->segment_ = segment;
+
+  if (created) {
+    if (!has_seed) {
+      // Seeds beyond 2^53 would not survive seed() as a JS number.
+      v8::base::RandomNumberGenerator rng;
+      rng.Reseed();
+      seed = rng.NextInt64() & ((int64_t{1} << 53) - 1);
+    }
+
+    memcpy(segment->magic, kMagic, sizeof(kMagic));
+    segment->version = kVersion;
+    segment->seed = seed;
+    segment->next_stream.store(0, std::memory_order_relaxed);
+    segment->ready.store(1, std::memory_order_release);
+    return std::string();
+  }
+
+  int tries = 0;
+  while (segment->ready.load(std::memory_order_acquire) == 0 && tries++ < 1000) {
+    SleepMillisecond();
+  }
+
+  if (segment->ready.load(std::memory_order_acquire) == 0 ||
+      memcmp(segment->magic, kMagic, sizeof(kMagic)) != 0 || segment->version != kVersion) {
+    return "Segment " + this->name_ + " is not a stream segment";
+  }
+
+  if (has_seed && segment->seed != seed) {
+    return "Segment " + this->name_ + " was created with another seed";
+  }
+
+  return std::string();
+}
+
+void SharedStreams::Start(v8::base::RandomNumberGenerator& rng, uint64_t id) const {
+  rng.SetSeed(this->segment_->seed);
+  JumpStreams(rng, id);
+}
+
+Napi::Value SharedStreams::Seed(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), static_cast<double>(this->segment_->seed));
+}
+
+uint64_t SharedStreams::ClaimNext(v8::base::RandomNumberGenerator& rng) {
+  const uint64_t id = this->segment_->next_stream.fetch_add(1, std::memory_order_relaxed);
+  Start(rng, id);
+  return id;
+}
+
+// claim(prng) puts the PRNG at the start of the next unclaimed stream and
+// returns its id. The PRNG keeps this object alive, to claim again in a
+// forked child.
+Napi::Value SharedStreams::Claim(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  PRNG* prng = info.Length() ? PRNG::Unwrap(info[0]) : nullptr;
+  if (prng == nullptr) {
+    Napi::TypeError::New(env, "PRNG (not sharing state, recording or replaying) expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  const uint64_t id = ClaimNext(prng->value_);
+  prng->from_entropy_ = false;
+  prng->streams_ = Napi::Persistent(Value());
+
+  return Napi::Number::New(env, static_cast<double>(id));
+}
+
+// select(prng, id) puts the PRNG at the start of stream |id|, for processes
+// that number themselves (e.g. by cluster worker id). It does not claim it,
+// and forked children go on with the same stream.
+void SharedStreams::Select(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  PRNG* prng = info.Length() ? PRNG::Unwrap(info[0]) : nullptr;
+  if (prng == nullptr) {
+    Napi::TypeError::New(env, "PRNG (not sharing state, recording or replaying) expected").ThrowAsJavaScriptException();
+    return;
+  }
+
+  if (info.Length() < 2 || !info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+    return;
+  }
+
+  const int64_t id = info[1].As<Napi::Number>().Int64Value();
+  if (id < 0) {
+    Napi::RangeError::New(env, "Stream id out of range").ThrowAsJavaScriptException();
+    return;
+  }
+
+  Start(prng->value_, static_cast<uint64_t>(id));
+  prng->from_entropy_ = false;
+  prng->streams_.Reset();
+}
+
+// Removes the segment name; processes attached to it keep working.
+void SharedStreams::Unlink(const Napi::CallbackInfo& info) {
+  if (shm_unlink(this->name_.c_str()) != 0 && errno != ENOENT) {
+    Napi::Error::New(info.Env(), std::string("shm_unlink: ") + strerror(errno)).ThrowAsJavaScriptException();
+  }
+}
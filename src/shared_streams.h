@@ -0,0 +1,67 @@
+#ifndef SHARED_STREAMS_H
+#define SHARED_STREAMS_H
+
+#include <napi.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "utils/random-number-generator.h"
+
+// Advances |rng| by streams * 2^64 steps. The xorshift128+ step (with V8's
+// shifts 23, 17, 26) is linear over GF(2)^128, so this is a product with
+// precomputed powers T^(2^64), T^(2^65), ... of the 128x128 step matrix T.
+// Stream k of a seed never overlaps stream k + 1 within 2^64 draws.
+void JumpStreams(v8::base::RandomNumberGenerator& rng, uint64_t streams);
+
+// Object that coordinates the streams of cooperating processes through a named
+// POSIX shared memory segment holding a master seed and a stream counter:
+// new SharedStreams(name[, seed]). The first process creates the segment with
+// |seed| (or one from the entropy source), every process then claims distinct
+// streams of the master generator with an atomic increment, no IPC needed.
+// A claimed PRNG claims another stream on its first draw in a forked child
+// (once reseedOnFork() installed the fork handler), so parent and children
+// never share one.
+class SharedStreams : public Napi::ObjectWrap<SharedStreams> {
+ public:
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+  SharedStreams(const Napi::CallbackInfo& info);
+  ~SharedStreams();
+
+  // Puts |rng| at the start of the next unclaimed stream and returns its id.
+  uint64_t ClaimNext(v8::base::RandomNumberGenerator& rng);
+
+ private:
+  struct Segment {
+    char magic[8];
+    std::atomic<uint32_t> ready;
+    uint32_t version;
+    int64_t seed;
+    std::atomic<uint64_t> next_stream;
+  };
+
+  static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+                "segment atomics must work across processes");
+
+  static constexpr char kMagic[8] = {'N', 'R', 'S', 'D', 'S', 'H', 'M', '1'};
+  static constexpr uint32_t kVersion = 1;
+
+  Napi::Value Seed(const Napi::CallbackInfo& info);
+  Napi::Value Claim(const Napi::CallbackInfo& info);
+  void Select(const Napi::CallbackInfo& info);
+  void Unlink(const Napi::CallbackInfo& info);
+
+  // Creates the segment or attaches to an existing one, returns an error
+  // message on failure.
+  std::string Open(bool has_seed, int64_t seed);
+
+  // Puts |rng| at the start of stream |id|.
+  void Start(v8::base::RandomNumberGenerator& rng, uint64_t id) const;
+
+  std::string name_;
+  Segment* segment_ = nullptr;
+};
+
+#endif
@@ -0,0 +1,176 @@
+#include "threadpool_reseed.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+
+#include "nreseed.h"
+
+#include "utils/time.h"
+
+// Crypto.randomBytes() runs on the threadpool, and every threadpool thread has
+// its own public/private DRBGs. They pick up a primary reseed lazily on their
+// next use anyway, this makes it happen now.
+//
+// libuv can't run a job on a given thread, so one job per thread is queued and
+// every job holds its thread until all of them have started (or the deadline
+// has passed, when the pool is busy with something else), so that no thread
+// runs two of them. Threads are held for at most kRendezvousTimeout plus one
+// reseed.
+
+namespace {
+
+constexpr auto kRendezvousTimeout = std::chrono::milliseconds(100);
+
+// Same defaults and limits as libuv.
+size_t ReadThreadpoolSize() {
+  const char* value = getenv("UV_THREADPOOL_SIZE");
+  const long size = value != nullptr ? atol(value) : 4;
+  return static_cast<size_t>(std::min(std::max(size, 1L), 1024L));
+}
+
+// libuv reads the variable once, when the pool starts, so it is read once as
+// well, when the addon loads: later changes to process.env don't resize the
+// pool and must not change the number of jobs.
+const size_t kThreadpoolSize = ReadThreadpoolSize();
+
+struct Rendezvous {
+  explicit Rendezvous(size_t jobs) : jobs(jobs) {}
+
+  const size_t jobs;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t started = 0;
+
+  // Touched on the main thread only.
+  size_t completed = 0;
+  std::string error;
+  std::vector<pthread_t> threads;
+  std::vector<double> latencies;
+};
+
+class ReseedWorker : public Napi::AsyncWorker {
+ public:
+  ReseedWorker(const Napi::Function& callback, std::shared_ptr<Rendezvous> rendezvous)
+      : Napi::AsyncWorker(callback), rendezvous_(std::move(rendezvous)) {}
+
+ protected:
+  void Execute() override {
+    Rendezvous& r = *this->rendezvous_;
+    {
+      std::unique_lock<std::mutex> lock(r.mutex);
+      r.started++;
+      r.cv.notify_all();
+      r.cv.wait_for(lock, kRendezvousTimeout, [&r] { return r.started == r.jobs; });
+    }
+
+    this->thread_ = pthread_self();
+
+    const int64_t start = v8::base::NanosecondsNow();
+    const int result = nreseed_reseed_openssl_thread();
+    this->latency_ = static_cast<double>(v8::base::NanosecondsNow() - start);
+
+    if (result != NRESEED_OK) {
+      SetError("EVP_RAND_reseed failed");
+    }
+  }
+
+  void OnOK() override {
+    Done();
+  }
+
+  void OnError(const Napi::Error& e) override {
+    this->rendezvous_->error = e.Message();
+    Done();
+  }
+
+ private:
+  // The last job to complete reports for all of them.
+  void Done() {
+    Rendezvous& r = *this->rendezvous_;
+
+    if (std::find_if(r.threads.begin(), r.threads.end(),
+                     [this](pthread_t t) { return pthread_equal(t, this->thread_); }) == r.threads.end()) {
+      r.threads.push_back(this->thread_);
+    }
+    r.latencies.push_back(this->latency_);
+
+    if (++r.completed != r.jobs) {
+      return;
+    }
+
+    Napi::Env env = Env();
+
+    if (!r.error.empty()) {
+      Callback().MakeCallback(Receiver().Value(), { Napi::Error::New(env, r.error).Value() });
+      return;
+    }
+
+    Napi::Float64Array latencies = Napi::Float64Array::New(env, r.latencies.size(), napi_float64_array);
+    std::copy(r.latencies.begin(), r.latencies.end(), latencies.Data());
+
+    Napi::Object stats = Napi::Object::New(env);
+    stats.Set("threads", Napi::Number::New(env, static_cast<double>(r.threads.size())));
+    stats.Set("latencies", latencies);
+
+    Callback().MakeCallback(Receiver().Value(), { env.Null(), stats });
+  }
+
+  std::shared_ptr<Rendezvous> rendezvous_;
+  pthread_t thread_;
+  double latency_ = 0;
+};
+
+}  // namespace
+
+// Calls back with (err, { threads, latencies }): the number of distinct threads
+// reached and per-job reseed latencies in nanoseconds.
+Napi::Value ReseedThreadpool(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  size_t threads = kThreadpoolSize;
+  size_t callback = 0;
+
+  if (info.Length() == 2) {
+    if (!info[0].IsNumber()) {
+      Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    // More jobs than threads would make some thread run two of them and hold
+    // the others until the rendezvous times out.
+    const int64_t n = info[0].As<Napi::Number>().Int64Value();
+    if (n < 1 || n > static_cast<int64_t>(kThreadpoolSize)) {
+      Napi::RangeError::New(env, "Number of threads out of range (1 to UV_THREADPOOL_SIZE)").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    threads = static_cast<size_t>(n);
+    callback = 1;
+  }
+
+  if (info.Length() != callback + 1 || !info[callback].IsFunction()) {
+    Napi::TypeError::New(env, "Expected reseedThreadpool([threads, ]callback)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  // The primary DRBG first, so that every thread reseeds from fresh entropy.
+  if (nreseed_reseed_openssl() != NRESEED_OK) {
+    Napi::TypeError::New(env, "EVP_RAND_reseed failed").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  auto rendezvous = std::make_shared<Rendezvous>(threads);
+  for (size_t i = 0; i < threads; i++) {
+    (new ReseedWorker(info[callback].As<Napi::Function>(), rendezvous))->Queue();
+  }
+
+  return env.Undefined();
+}
@@ -0,0 +1,10 @@
+#ifndef THREADPOOL_RESEED_H
+#define THREADPOOL_RESEED_H
+
+#include <napi.h>
+
+// reseedThreadpool([threads, ]callback) reseeds OpenSSL public/private DRBGs
+// of every libuv threadpool thread, see threadpool_reseed.cc.
+Napi::Value ReseedThreadpool(const Napi::CallbackInfo& info);
+
+#endif
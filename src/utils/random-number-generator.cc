@@ -10,6 +10,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <algorithm>
 #include <chrono>
@@ -26,6 +27,23 @@ inline constexpr bool IsPowerOfTwo(int value) {
 int RandomNumberGenerator::NextInt(int max) {
   DCHECK_LT(0, max);
 
+  if (!v8_compatible_) {
+    // Rejection sampling on just enough bits, less than two tries on average.
+    if (max == 1) {
+      return 0;
+    }
+    int bits = 1;
+    while ((max - 1) >> bits) {
+      bits++;
+    }
+    while (true) {
+      const uint32_t rnd = NextBits(bits);
+      if (rnd < static_cast<uint32_t>(max)) {
+        return static_cast<int>(rnd);
+      }
+    }
+  }
+
   // Fast path if max is a power of 2.
   if (IsPowerOfTwo(max)) {
     return static_cast<int>((max * static_cast<int64_t>(Next(31))) >> 31);
@@ -59,6 +77,20 @@ void RandomNumberGenerator::NextBytes(void* buffer, size_t buflen) {
   }
 }
 
+void RandomNumberGenerator::FillBytes(void* buffer, size_t buflen) {
+  uint8_t* p = static_cast<uint8_t*>(buffer);
+
+  for (; buflen >= sizeof(uint64_t); buflen -= sizeof(uint64_t), p += sizeof(uint64_t)) {
+    const int64_t v = NextInt64();
+    memcpy(p, &v, sizeof(v));
+  }
+
+  if (buflen > 0) {
+    const int64_t v = NextInt64();
+    memcpy(p, &v, buflen);
+  }
+}
+
 static std::vector<uint64_t> ComplementSample(
     const std::unordered_set<uint64_t>& set, uint64_t max) {
   std::vector<uint64_t> result;
@@ -149,6 +181,7 @@ int RandomNumberGenerator::Next(int bits) {
 
 void RandomNumberGenerator::SetSeed(int64_t seed) {
   initial_seed_ = seed;
+  bits_left_ = 0;
   state0_ = MurmurHash3(base::bit_cast<uint64_t>(seed));
   state1_ = MurmurHash3(~state0_);
   CHECK(state0_ != 0 || state1_ != 0);
@@ -0,0 +1,159 @@
+#include "weighted_sampler.h"
+
+#include <cmath>
+
+bool AliasTable::Build(const std::vector<double>& weights) {
+  const size_t n = weights.size();
+
+  double sum = 0;
+  for (double w : weights) {
+    if (!std::isfinite(w) || w < 0) {
+      return false;
+    }
+    sum += w;
+  }
+
+  if (n == 0 || !(sum > 0) || !std::isfinite(sum)) {
+    return false;
+  }
+
+  prob_.resize(n);
+  alias_.resize(n);
+
+  std::vector<double> scaled(n);
+  std::vector<uint32_t> small;
+  std::vector<uint32_t> large;
+
+  for (size_t i = 0; i < n; i++) {
+    scaled[i] = weights[i] * n / sum;
+    (scaled[i] < 1 ? small : large).push_back(static_cast<uint32_t>(i));
+  }
+
+  while (!small.empty() && !large.empty()) {
+    const uint32_t l = small.back();
+    const uint32_t g = large.back();
+    small.pop_back();
+
+    prob_[l] = scaled[l];
+    alias_[l] = g;
+
+    scaled[g] = (scaled[g] + scaled[l]) - 1;
+    if (scaled[g] < 1) {
+      large.pop_back();
+      small.push_back(g);
+    }
+  }
+
+  // Whatever is left is 1 up to the rounding errors.
+  for (uint32_t i : large) {
+    prob_[i] = 1;
+    alias_[i] = i;
+  }
+  for (uint32_t i : small) {
+    prob_[i] = 1;
+    alias_[i] = i;
+  }
+
+  return true;
+}
+
+Napi::Object WeightedSampler::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func =
+      DefineClass(env,
+                  "WeightedSampler", {
+                  InstanceMethod("sample",     &WeightedSampler::Sample),
+                  InstanceMethod("sampleInto", &WeightedSampler::SampleInto),
+                  InstanceMethod("update",     &WeightedSampler::Update)});
+
+  exports.Set("WeightedSampler", func);
+
+  return exports;
+}
+
+WeightedSampler::WeightedSampler(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<WeightedSampler>(info) {
+  Napi::Env env = info.Env();
+
+  if (!info.Length() || !info[0].IsTypedArray() ||
+      info[0].As<Napi::TypedArray>().TypedArrayType() != napi_float64_array) {
+    Napi::TypeError::New(env, "Float64Array expected").ThrowAsJavaScriptException();
+    return;
+  }
+
+  if (!this->source_.Init(env, info[1])) {
+    return;
+  }
+
+  Napi::Float64Array weights = info[0].As<Napi::Float64Array>();
+  this->weights_.assign(weights.Data(), weights.Data() + weights.ElementLength());
+
+  Prepare(env);
+}
+
+bool WeightedSampler::Prepare(Napi::Env env) {
+  if (!this->dirty_) {
+    return true;
+  }
+
+  if (!this->table_.Build(this->weights_)) {
+    Napi::RangeError::New(env, "Weights must be finite, non-negative and not all zero").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  this->dirty_ = false;
+  return true;
+}
+
+Napi::Value WeightedSampler::Sample(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!Prepare(env)) {
+    return env.Null();
+  }
+
+  return Napi::Number::New(env, this->table_.Sample(this->source_.rng()));
+}
+
+Napi::Value WeightedSampler::SampleInto(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!info.Length() || !info[0].IsTypedArray() ||
+      info[0].As<Napi::TypedArray>().TypedArrayType() != napi_uint32_array) {
+    Napi::TypeError::New(env, "Uint32Array expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  if (!Prepare(env)) {
+    return env.Null();
+  }
+
+  Napi::Uint32Array out = info[0].As<Napi::Uint32Array>();
+  uint32_t* data = out.Data();
+  const size_t length = out.ElementLength();
+
+  v8::base::RandomNumberGenerator& rng = this->source_.rng();
+  for (size_t i = 0; i < length; i++) {
+    data[i] = this->table_.Sample(rng);
+  }
+
+  return out;
+}
+
+// Weight changes are cheap: the table is rebuilt once on the next sample.
+void WeightedSampler::Update(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() != 2 || !info[0].IsNumber() || !info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Expected update(index, weight)").ThrowAsJavaScriptException();
+    return;
+  }
+
+  const int64_t index = info[0].As<Napi::Number>().Int64Value();
+  if (index < 0 || static_cast<uint64_t>(index) >= this->weights_.size()) {
+    Napi::RangeError::New(env, "Index out of range").ThrowAsJavaScriptException();
+    return;
+  }
+
+  this->weights_[index] = info[1].As<Napi::Number>().DoubleValue();
+  this->dirty_ = true;
+}
@@ -0,0 +1,52 @@
+#ifndef WEIGHTED_SAMPLER_H
+#define WEIGHTED_SAMPLER_H
+
+#include <napi.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "prng.h"
+
+// Vose's alias table: O(n) to build, O(1) and one generator step per sample.
+class AliasTable {
+ public:
+  // Returns false if weights are negative, not finite or sum up to zero.
+  bool Build(const std::vector<double>& weights);
+
+  uint32_t Sample(v8::base::RandomNumberGenerator& rng) const {
+    const double u = rng.NextDouble() * prob_.size();
+    uint32_t i = static_cast<uint32_t>(u);
+    if (i >= prob_.size()) {
+      i = static_cast<uint32_t>(prob_.size() - 1);
+    }
+    return u - i < prob_[i] ? i : alias_[i];
+  }
+
+ private:
+  std::vector<double> prob_;
+  std::vector<uint32_t> alias_;
+};
+
+// Object that picks indices proportionally to their weights.
+class WeightedSampler : public Napi::ObjectWrap<WeightedSampler> {
+ public:
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+  WeightedSampler(const Napi::CallbackInfo& info);
+
+ private:
+  Napi::Value Sample(const Napi::CallbackInfo& info);
+  Napi::Value SampleInto(const Napi::CallbackInfo& info);
+  void Update(const Napi::CallbackInfo& info);
+
+  // Rebuilds the table after updates, throws if weights became invalid.
+  bool Prepare(Napi::Env env);
+
+  RandomSource source_;
+  std::vector<double> weights_;
+  AliasTable table_;
+  bool dirty_ = true;
+};
+
+#endif
@@ -0,0 +1,58 @@
+// jshint esversion: 6
+
+var seeder = require('../pkg/seeder');
+var assert = require('assert');
+
+function near(actual, expected, tolerance) {
+  assert(Math.abs(actual - expected) <= tolerance * expected,
+         actual + ' is not close to ' + expected);
+}
+
+// --- sample() and fillMask() hit p on average and continue each other
+
+const s = new seeder.BernoulliSampler(0.01, 1);
+let hits = 0;
+for (let i = 0; i < 1000000; i++) {
+  hits += s.sample() ? 1 : 0;
+}
+near(hits, 10000, 0.05);
+
+const mask = new Uint8Array(1000000);
+const ones = s.fillMask(mask);
+assert.equal(ones, mask.reduce((a, b) => a + b, 0));
+assert(mask.every(x => x === 0 || x === 1));
+near(ones, 10000, 0.05);
+
+// the same stream whether decided one by one or in batches
+const a = new seeder.BernoulliSampler(0.3, 2);
+const b = new seeder.BernoulliSampler(0.3, 2);
+const batch = new Uint8Array(100);
+b.fillMask(batch.subarray(0, 37));
+b.fillMask(batch.subarray(37));
+for (let i = 0; i < 100; i++) {
+  assert.equal(a.sample(), batch[i] === 1);
+}
+
+// --- fastBernoulli() counts down in JS
+
+const keep = seeder.fastBernoulli(new seeder.BernoulliSampler(0.001, 3));
+hits = 0;
+for (let i = 0; i < 10000000; i++) {
+  hits += keep() ? 1 : 0;
+}
+near(hits, 10000, 0.05);
+
+// --- edge probabilities
+
+const never = new seeder.BernoulliSampler(0);
+assert.equal(never.sample(), false);
+assert.equal(never.gap(), Infinity);
+assert.equal(never.fillMask(new Uint8Array(10)), 0);
+
+const always = new seeder.BernoulliSampler(1);
+assert.equal(always.sample(), true);
+assert.equal(always.fillMask(new Uint8Array(10)), 10);
+
+assert.throws(() => new seeder.BernoulliSampler(1.5), RangeError);
+assert.throws(() => new seeder.BernoulliSampler(), TypeError);
+assert.throws(() => s.fillMask(new Float64Array(1)), TypeError);
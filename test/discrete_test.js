@@ -0,0 +1,65 @@
+// jshint esversion: 6
+
+var seeder = require('../pkg/seeder');
+var assert = require('assert');
+
+function moments(out) {
+  let sum = 0, sum2 = 0;
+  for (let i = 0; i < out.length; i++) {
+    assert.equal(out[i], Math.floor(out[i]));
+    sum += out[i];
+    sum2 += out[i] * out[i];
+  }
+  const mean = sum / out.length;
+  return { mean: mean, variance: sum2 / out.length - mean * mean };
+}
+
+function near(actual, expected, tolerance) {
+  assert(Math.abs(actual - expected) <= tolerance * Math.max(1, expected),
+         actual + ' is not close to ' + expected);
+}
+
+const out = new Float64Array(200000);
+
+// --- Poisson, both inversion and PTRS
+
+[0.5, 4, 10, 1000, 1e6].forEach(lambda => {
+  const m = moments(new seeder.Poisson(lambda, 1).fill(out));
+  near(m.mean, lambda, 0.01);
+  near(m.variance, lambda, 0.03);
+});
+
+// --- binomial, both inversion and BTPE, and p > 0.5
+
+[[10, 0.3], [1000, 0.5], [1000, 0.99], [1e9, 1e-3]].forEach(c => {
+  const m = moments(new seeder.Binomial(c[0], c[1], 2).fill(out));
+  near(m.mean, c[0] * c[1], 0.01);
+  near(m.variance, c[0] * c[1] * (1 - c[1]), 0.03);
+});
+
+const b = new seeder.Binomial(20, 1);
+assert.equal(b.sample(), 20);
+
+// --- geometric counts trials up to the first success
+
+[1, 0.5, 0.01].forEach(p => {
+  const m = moments(new seeder.Geometric(p, 3).fill(out));
+  near(m.mean, 1 / p, 0.02);
+  assert(out.every(x => x >= 1));
+});
+
+// --- same seed, same draws
+
+const prng = new seeder.PRNG(5);
+const g = new seeder.Geometric(0.1, prng);
+const first = g.sample();
+prng.setSeed(5);
+assert.equal(g.sample(), first);
+
+assert.throws(() => new seeder.Poisson(-1), RangeError);
+assert.throws(() => new seeder.Binomial(10.5, 0.5), RangeError);
+assert.throws(() => new seeder.Binomial(10, 2), RangeError);
+assert.throws(() => new seeder.Geometric(0), RangeError);
+assert.throws(() => new seeder.Geometric(), TypeError);
+assert.throws(() => new seeder.Poisson(1, 'seed'), TypeError);
+assert.throws(() => new seeder.Poisson(1).fill([]), TypeError);
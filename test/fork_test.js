@@ -2,6 +2,9 @@
 
 var seeder = require('../pkg/seeder');
 var assert = require('assert');
+var fs = require('fs');
+var os = require('os');
+var path = require('path');
 var crypto;
 
 try {
@@ -66,3 +69,46 @@ if (waitpid(pid) != 0) {
 
 test1();
 log("parent done");
+
+// --- with reseedOnFork(), a child doesn't repeat the randomness of the parent,
+// except for generators with a fixed seed
+
+seeder.reseedOnFork();
+seeder.reseed();
+
+const prng = new seeder.PRNG();
+const fixed = new seeder.PRNG(1);
+const pool = new seeder.PRNGPool(2);
+Math.random();
+prng.random();
+fixed.random();
+pool.random(0);
+
+function draws() {
+  const bytes = new Uint32Array(4);
+  getRandomValues(bytes);
+  return [Math.random(), prng.random(), pool.random(0), Array.from(bytes), fixed.random()];
+}
+
+const file = path.join(os.tmpdir(), 'nreseed-fork-' + getpid() + '.json');
+const child = fork();
+
+if (child == 0) {
+  fs.writeFileSync(file, JSON.stringify(draws()));
+  process.exit(0);
+}
+
+assert.equal(waitpid(child), 0);
+const theirs = JSON.parse(fs.readFileSync(file, 'utf8'));
+fs.unlinkSync(file);
+const ours = draws();
+
+log("child draws = ", JSON.stringify(theirs));
+log("parent draws = ", JSON.stringify(ours));
+assert.notEqual(theirs[0], ours[0]);
+assert.notEqual(theirs[1], ours[1]);
+assert.notEqual(theirs[2], ours[2]);
+if (crypto) {
+  assert.notDeepEqual(theirs[3], ours[3]);
+}
+assert.equal(theirs[4], ours[4]);
@@ -0,0 +1,40 @@
+// jshint esversion: 6
+
+var seeder = require('../pkg/seeder');
+var assert = require('assert');
+
+// --- every index is visited exactly once
+
+for (const n of [1, 2, 3, 1000, 65537]) {
+  const p = new seeder.Permutation(n, 0);
+  const out = new Uint32Array(n);
+  assert.equal(p.fill(out), n);
+  assert.equal(new Set(out).size, n);
+  assert(out.every((i) => i < n));
+
+  for (let i = 0; i < n; i++) {
+    assert.equal(p.next(), out[i]);
+  }
+  assert.equal(p.next(), -1);
+
+  p.reset();
+  assert.equal(p.next(), p.at(0));
+}
+
+// --- chunks can be computed independently, and seeds are reproducible
+
+const a = new seeder.Permutation(1e9, 1);
+const b = new seeder.Permutation(1e9, new seeder.PRNG(1));
+const chunk = new Float64Array(16);
+assert.equal(a.fill(chunk, 1e6), 16);
+for (let i = 0; i < chunk.length; i++) {
+  assert.equal(chunk[i], b.at(1e6 + i));
+}
+console.log("Permutation(1e9).fill(1e6) = " + chunk);
+
+const huge = new seeder.Permutation(2 ** 53);
+assert(huge.at(2 ** 53 - 1) < 2 ** 53);
+assert.equal(a.fill(chunk, 1e9 - 4), 4);
+assert.throws(() => huge.fill(new Uint32Array(1)), RangeError);
+assert.throws(() => a.at(1e9), RangeError);
+assert.throws(() => new seeder.Permutation(0), RangeError);
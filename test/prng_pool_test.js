@@ -0,0 +1,41 @@
+// jshint esversion: 6
+
+var seeder = require('../pkg/seeder');
+var assert = require('assert');
+
+// --- stream i of a pool seeded with s is PRNG(s + i)
+
+const pool = new seeder.PRNGPool(1000, 0);
+assert.equal(pool.size(), 1000);
+assert.equal(pool.random(0), 0.39339363837962904);
+assert.equal(pool.random(0), 0.39339364003432853);
+assert.equal(pool.random(1), 0.7662037068107435);
+
+const p7 = new seeder.PRNG(7);
+const out = new Float64Array(1000);
+pool.fill(out);
+assert.equal(out[7], p7.random());
+
+// --- randomInto() advances only the given streams
+
+const doubles = new Float64Array(3);
+pool.randomInto(new Uint32Array([7, 7, 999]), doubles);
+assert.equal(doubles[0], p7.random());
+assert.equal(doubles[1], p7.random());
+const p999 = new seeder.PRNG(999);
+p999.random();
+assert.equal(doubles[2], p999.random());
+
+pool.setSeed(3, 1);
+assert.equal(pool.random(3), 0.7662037068107435);
+
+// --- reseeded pools differ
+
+const a = new seeder.PRNGPool(2);
+const b = new seeder.PRNGPool(2);
+assert.notEqual(a.random(0), b.random(0));
+a.reseed();
+
+assert.throws(() => pool.random(1000), RangeError);
+assert.throws(() => pool.fill(new Float64Array(1001)), RangeError);
+assert.throws(() => pool.randomInto(new Uint32Array([1000]), doubles), RangeError);
@@ -0,0 +1,101 @@
+// jshint esversion: 6
+
+var seeder = require('../pkg/seeder');
+var assert = require('assert');
+
+// --- unscrambled sequences are well known
+
+const s = new seeder.Sobol(2);
+const sp = s.fill(new Float64Array(8), 4);
+console.log("Sobol(2) = " + sp);
+assert.deepEqual(Array.from(sp), [0, 0, 0.5, 0.5, 0.75, 0.25, 0.25, 0.75]);
+
+const h = new seeder.Halton(2);
+const hp = h.fill(new Float64Array(6), 3);
+console.log("Halton(2) = " + hp);
+assert.deepEqual(Array.from(hp), [0, 0, 0.5, 1 / 3, 0.25, 2 / 3]);
+assert.equal(h.index(), 3);
+
+// --- direction numbers are Joe-Kuo's, the first points match other libraries
+
+const s4 = new seeder.Sobol(4);
+assert.deepEqual(Array.from(s4.fill(new Float64Array(4 * 8), 8)), [
+  0, 0, 0, 0,
+  0.5, 0.5, 0.5, 0.5,
+  0.75, 0.25, 0.25, 0.25,
+  0.25, 0.75, 0.75, 0.75,
+  0.375, 0.375, 0.625, 0.875,
+  0.875, 0.875, 0.125, 0.375,
+  0.625, 0.125, 0.875, 0.625,
+  0.125, 0.625, 0.375, 0.125]);
+
+// --- 2^m points of two Sobol dimensions are a (t, m, 2)-net: every elementary
+// interval [i / 2^a, (i + 1) / 2^a) x [j / 2^b, (j + 1) / 2^b) with a + b = m - t
+// holds exactly 2^t points. Scrambling keeps the property.
+
+function netQuality(points, dims, x, y, m) {
+  const n = 1 << m;
+  for (let t = 0; t <= m; t++) {
+    let net = true;
+    for (let a = 0; a <= m - t && net; a++) {
+      const b = m - t - a;
+      const counts = new Uint32Array(1 << (m - t));
+      for (let i = 0; i < n; i++) {
+        const cx = Math.floor(points[i * dims + x] * (1 << a));
+        const cy = Math.floor(points[i * dims + y] * (1 << b));
+        counts[(cx << b) | cy]++;
+      }
+      net = counts.every((c) => c === 1 << t);
+    }
+    if (net) {
+      return t;
+    }
+  }
+  return m;
+}
+
+for (const scramble of [false, true]) {
+  const dims = 8;
+  const m = 10;
+  const q = new seeder.Sobol(dims, 0, scramble);
+  const points = q.fill(new Float64Array(dims * (1 << m)), 1 << m);
+
+  assert.equal(netQuality(points, dims, 0, 1, m), 0);
+  for (let x = 0; x < dims; x++) {
+    for (let y = x + 1; y < dims; y++) {
+      assert(netQuality(points, dims, x, y, m) <= 3, "dimensions " + x + " and " + y);
+    }
+  }
+}
+
+// --- every dimension of 2^m points is stratified, scrambled or not
+
+for (const Engine of [seeder.Sobol, seeder.Halton]) {
+  const dims = 64;
+  const n = 1024;
+  const q = new Engine(dims, 0, true);
+  const out = q.fill(new Float64Array(dims * n), n, true);
+
+  for (let d = 0; d < (Engine === seeder.Sobol ? dims : 1); d++) {
+    const cells = new Set();
+    for (let i = 0; i < n; i++) {
+      cells.add(Math.floor(out[d * n + i] * n));
+    }
+    assert.equal(cells.size, n);
+  }
+  assert(out.every((x) => x >= 0 && x < 1));
+}
+
+// --- skip() is the same as generating
+
+for (const Engine of [seeder.Sobol, seeder.Halton]) {
+  const a = new Engine(5, 1, true);
+  const b = new Engine(5, 1, true);
+  a.fill(new Float64Array(5 * 1000), 1000);
+  b.skip(1000);
+  assert.deepEqual(a.fill(new Float64Array(5), 1), b.fill(new Float64Array(5), 1));
+}
+
+assert.throws(() => new seeder.Sobol(1112), RangeError);
+assert.throws(() => s.fill(new Float64Array(3), 2), RangeError);
+assert.throws(() => s.skip(2 ** 33), RangeError);
@@ -0,0 +1,46 @@
+// jshint esversion: 6
+
+var seeder = require('../pkg/seeder');
+var assert = require('assert');
+
+function collect(options, done) {
+  const chunks = [];
+  seeder.createRandomStream(options)
+    .on('data', (chunk) => chunks.push(chunk))
+    .on('error', done)
+    .on('end', () => done(null, Buffer.concat(chunks)));
+}
+
+// --- same seed, same bytes; length is honoured across chunk boundaries
+
+collect({ prng: 0, chunkSize: 1000, length: 4500 }, function(err, a) {
+  assert.ifError(err);
+  assert.equal(a.length, 4500);
+
+  collect({ prng: new seeder.PRNG(0), chunkSize: 1000, length: 4500, prefill: false }, function(err, b) {
+    assert.ifError(err);
+    assert(a.equals(b));
+    console.log("createRandomStream(prng) = " + a.subarray(0, 8).toString('hex'));
+  });
+});
+
+// --- secure chunks, a given prng is not drawn from
+
+const untouched = new seeder.PRNG(3);
+collect({ secure: true, prng: untouched, chunkSize: 4096, length: 10000 }, function(err, c) {
+  assert.ifError(err);
+  assert.equal(c.length, 10000);
+  assert.notEqual(c.subarray(0, 4096).toString('hex'), c.subarray(4096, 8192).toString('hex'));
+  assert.equal(untouched.random(), new seeder.PRNG(3).random());
+});
+
+// --- backpressure: chunks are generated on demand
+
+const s = seeder.createRandomStream({ chunkSize: 16, prefill: false });
+assert.equal(s.read(16), null);
+s.once('readable', function() {
+  assert.equal(s.read(16).length, 16);
+  s.destroy();
+});
+
+assert.throws(() => seeder.createRandomStream({ chunkSize: -1 }), RangeError);
@@ -0,0 +1,108 @@
+// jshint esversion: 6
+
+var seeder = require('../pkg/seeder');
+var assert = require('assert');
+var fs = require('fs');
+var os = require('os');
+var path = require('path');
+
+const file = path.join(os.tmpdir(), 'nreseed-replay-' + process.pid + '.log');
+
+// --- replay returns the recorded draws, then goes on live
+
+const prng = new seeder.PRNG(42);
+prng.record(file, 64);
+const recorded = [];
+for (let i = 0; i < 1000; i++) {
+  recorded.push(prng.random());
+}
+prng.stop();
+
+const live = [];
+for (let i = 0; i < 10; i++) {
+  live.push(prng.random());
+}
+
+const replay = new seeder.PRNG();
+replay.replay(file);
+for (let i = 0; i < 1000; i++) {
+  assert.equal(replay.random(), recorded[i]);
+}
+for (let i = 0; i < 10; i++) {
+  assert.equal(replay.random(), live[i]);
+}
+
+// --- seek, and stop() leaves the generator at the current position
+
+replay.replay(file);
+replay.seek(500);
+assert.equal(replay.random(), recorded[500]);
+replay.seek(130);
+assert.equal(replay.random(), recorded[130]);
+replay.stop();
+assert.equal(replay.random(), recorded[131]);
+
+replay.replay(file);
+replay.seek(1000);
+assert.equal(replay.random(), live[0]);
+
+// --- the header is current at every checkpoint, a crashed recording is
+// readable up to the last one
+
+const crash = file + '.crash';
+const copy = file + '.copy';
+const c = new seeder.PRNG(7);
+c.record(crash, 64);
+const drawn = [];
+for (let i = 0; i < 200; i++) {
+  drawn.push(c.random());
+}
+fs.copyFileSync(crash, copy);
+c.stop();
+
+const crashed = new seeder.PRNG(1);
+crashed.replay(copy);
+for (let i = 0; i < 192; i++) {
+  assert.equal(crashed.random(), drawn[i]);
+}
+crashed.stop();
+
+// --- header fields are checked against the file size
+
+const header = fs.readFileSync(crash);
+// interval = 2^62, draws = 201 and draws = 2^63 + 200, as 32-bit words.
+for (const [offset, value] of [[28, 0x40000000], [32, 201], [36, 0x80000000]]) {
+  const corrupted = Buffer.from(header);
+  corrupted.writeUInt32LE(value, offset);
+  fs.writeFileSync(copy, corrupted);
+  assert.throws(() => crashed.replay(copy), Error);
+}
+fs.unlinkSync(crash);
+fs.unlinkSync(copy);
+
+// --- misuse
+
+const r = new seeder.PRNG(1);
+r.replay(file);
+assert.throws(() => r.seek(1001), RangeError);
+assert.throws(() => r.record(file), Error);
+r.stop();
+assert.throws(() => r.seek(0), Error);
+
+r.record(file);
+assert.throws(() => r.reseed(), Error);
+assert.throws(() => r.setSeed(1), Error);
+assert.throws(() => new seeder.WeightedSampler(new Float64Array([1]), r), TypeError);
+r.stop();
+
+// a PRNG that a sampler draws from can't be recorded or replayed
+const borrowed = new seeder.PRNG(1);
+const sampler = new seeder.WeightedSampler(new Float64Array([1, 1]), borrowed);
+assert.throws(() => borrowed.record(file), Error);
+assert.throws(() => borrowed.replay(file), Error);
+assert(sampler.sample() < 2);
+
+fs.writeFileSync(file, 'not a log');
+assert.throws(() => r.replay(file), Error);
+fs.unlinkSync(file);
+assert.throws(() => r.replay(file), Error);
@@ -0,0 +1,53 @@
+// jshint esversion: 6
+
+var seeder = require('../pkg/seeder');
+var assert = require('assert');
+
+function chunk(from, length) {
+  const ids = new Uint32Array(length);
+  for (let i = 0; i < length; i++) {
+    ids[i] = from + i;
+  }
+  return ids;
+}
+
+// --- uniform sample fills up first, then keeps k of the whole stream
+
+const r = new seeder.Reservoir(10, 0);
+r.add(chunk(0, 4));
+assert.deepEqual(Array.from(r.sample()), [0, 1, 2, 3]);
+
+for (let i = 4; i < 100000; i += 1000) {
+  r.add(chunk(i, 1000));
+}
+
+const s = r.sample();
+console.log("Reservoir.sample() = " + s);
+assert.equal(r.count(), 100004);
+assert.equal(s.length, 10);
+assert.equal(new Set(s).size, 10);
+assert(s.some((id) => id >= 10));
+
+// sample() is a view of the reservoir, so it follows later replacements
+r.add(chunk(100000, 1000000));
+assert.equal(r.count(), 1100004);
+assert.deepEqual(Array.from(s), Array.from(r.sample()));
+
+// --- weighted: zero weights are never picked, heavy ones dominate
+
+const w = new seeder.Reservoir(1, new seeder.PRNG(0));
+const hits = [0, 0, 0];
+for (let t = 0; t < 3000; t++) {
+  const one = new seeder.Reservoir(1, t);
+  one.add(new Uint32Array([0, 1, 2]), new Float64Array([1, 0, 9]));
+  hits[one.sample()[0]]++;
+}
+
+console.log("Reservoir weighted hits = " + hits);
+assert.equal(hits[1], 0);
+assert(hits[2] > hits[0] * 5);
+
+w.add(new Uint32Array([7]), new Float64Array([1]));
+assert.throws(() => w.add(new Uint32Array([8])), TypeError);
+assert.throws(() => w.add(new Uint32Array([8]), new Float64Array([-1])), RangeError);
+assert.throws(() => new seeder.Reservoir(0), RangeError);
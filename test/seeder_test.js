@@ -49,3 +49,88 @@ const t4 = Math.random();
 assert.notEqual(t1, t3);
 assert.notEqual(t2, t4);
 assert.notEqual(t3, t4);
+
+// --- fork handler is installed once, repeated calls are fine
+
+seeder.reseedOnFork();
+seeder.reseedOnFork();
+
+// --- fastRandom() is bit-exact with PRNG.random() and shares its state
+
+const f = new seeder.PRNG(0);
+const fast = seeder.fastRandom(f);
+console.log("fastRandom() = " + must_be_eq(fast(), 0.39339363837962904));
+console.log("PRNG.random(shared) = " + must_be_eq(f.random(), 0.39339364003432853));
+
+const g = new seeder.PRNG(0);
+for (let i = 0; i < 2; i++) {
+  g.random();
+}
+for (let i = 0; i < 1000; i++) {
+  assert.equal(i % 2 ? fast() : f.random(), g.random());
+}
+
+f.setSeed(1);
+console.log("fastRandom(setSeed(1)) = " + must_be_eq(fast(), 0.7662037068107435));
+
+// seeder.reseed() files a request, the next step reseeds
+const state = f.sharedState();
+const before = Array.from(state.subarray(0, 4));
+const same = new seeder.PRNG(1);
+same.random();
+seeder.reseed();
+assert.deepEqual(Array.from(state.subarray(0, 4)), before);
+assert.notEqual(fast(), same.random());
+assert.notDeepEqual(Array.from(state.subarray(0, 4)), before);
+
+// setSeed() wins over a pending request
+seeder.reseed();
+f.setSeed(1);
+console.log("fastRandom(reseed(), setSeed(1)) = " + must_be_eq(fast(), 0.7662037068107435));
+assert.throws(() => new seeder.WeightedSampler(new Float64Array([1]), f), TypeError);
+
+// nor can a PRNG that a sampler draws from switch to shared state
+const borrowed = new seeder.PRNG(2);
+const sampler = new seeder.WeightedSampler(new Float64Array([1, 1]), borrowed);
+assert.throws(() => seeder.fastRandom(borrowed), Error);
+assert.throws(() => borrowed.sharedState(), Error);
+assert(sampler.sample() < 2);
+
+// --- bools() and bits() come from a bit reservoir, random() is unaffected
+
+const r1 = new seeder.PRNG(3);
+const r2 = new seeder.PRNG(3);
+const flips = r1.bools(new Uint8Array(64));
+assert(flips.every(x => x === 0 || x === 1));
+r2.random();
+assert.equal(r1.random(), r2.random());
+
+const fair = new seeder.PRNG(4).bools(new Uint8Array(100000)).reduce((a, b) => a + b, 0);
+assert(Math.abs(fair - 50000) < 1000);
+
+const compat = new seeder.PRNG(3);
+compat.setV8Compatible(true);
+compat.bools(new Uint8Array(64));
+for (let i = 0; i < 62; i++) {
+  r2.random();
+}
+assert.equal(compat.random(), r2.random());
+
+assert(r1.bits(5) < 32);
+assert(r1.bits(32) <= 0xffffffff);
+assert.throws(() => r1.bits(33), RangeError);
+assert.throws(() => r1.bools(new Float64Array(1)), TypeError);
+
+// --- every threadpool thread gets reseeded
+
+seeder.reseedThreadpool(2, function(err, stats) {
+  assert.ifError(err);
+  console.log("reseedThreadpool(2) = " + JSON.stringify({ threads: stats.threads, latencies: Array.from(stats.latencies) }));
+  assert.equal(stats.latencies.length, 2);
+  assert(stats.threads >= 1 && stats.threads <= 2);
+});
+
+assert.throws(() => seeder.reseedThreadpool(0, () => {}), RangeError);
+assert.throws(() => seeder.reseedThreadpool('2', () => {}), TypeError);
+assert.throws(() => seeder.reseedThreadpool(1025, () => {}), RangeError);
+assert.throws(() => seeder.reseedThreadpool(), TypeError);
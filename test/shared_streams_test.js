@@ -0,0 +1,97 @@
+// jshint esversion: 6
+
+var seeder = require('../pkg/seeder');
+var assert = require('assert');
+var child_process = require('child_process');
+var fs = require('fs');
+var os = require('os');
+var path = require('path');
+
+const name = 'nreseed-test-' + process.pid;
+
+// --- streams are claimed in order, stream 0 is the master generator itself
+
+const streams = new seeder.SharedStreams(name, 42);
+assert.equal(streams.seed(), 42);
+
+const a = new seeder.PRNG();
+const b = new seeder.PRNG();
+assert.equal(streams.claim(a), 0);
+assert.equal(streams.claim(b), 1);
+
+const master = new seeder.PRNG(42);
+assert.equal(a.random(), master.random());
+assert.notEqual(b.random(), master.random());
+
+// select() repeats a stream without claiming it
+const c = new seeder.PRNG();
+streams.select(c, 1);
+b.setSeed(0);
+streams.select(b, 1);
+assert.equal(c.random(), b.random());
+
+// --- other processes attach to the same segment and counter
+
+const attached = new seeder.SharedStreams(name);
+assert.equal(attached.seed(), 42);
+assert.equal(attached.claim(new seeder.PRNG()), 2);
+
+const child = child_process.execFileSync(process.execPath, ['-e', `
+  const seeder = require(${JSON.stringify(path.join(__dirname, '../pkg/seeder'))});
+  const prng = new seeder.PRNG();
+  const id = new seeder.SharedStreams(${JSON.stringify(name)}).claim(prng);
+  console.log(JSON.stringify([id, prng.random()]));
+`]).toString();
+
+const claimed = JSON.parse(child);
+assert.equal(claimed[0], 3);
+const d = new seeder.PRNG();
+streams.select(d, 3);
+assert.equal(claimed[1], d.random());
+
+assert.throws(() => new seeder.SharedStreams(name, 7), Error);
+assert.throws(() => streams.claim(42), TypeError);
+assert.throws(() => streams.select(d, -1), RangeError);
+assert.throws(() => new seeder.SharedStreams('a/b'), RangeError);
+
+streams.unlink();
+
+// --- a fresh segment gets a seed from the entropy source
+
+const fresh = new seeder.SharedStreams(name);
+assert(Number.isSafeInteger(fresh.seed()));
+fresh.unlink();
+
+// --- a claimed PRNG claims the next stream on its first draw in a forked
+// child, the parent goes on with its own
+
+seeder.reseedOnFork();
+
+const forking = new seeder.SharedStreams(name, 5);
+const p = new seeder.PRNG();
+assert.equal(forking.claim(p), 0);
+p.random();
+
+const file = path.join(os.tmpdir(), name + '.json');
+const pid = seeder.internal.fork();
+
+if (pid == 0) {
+  fs.writeFileSync(file, JSON.stringify(p.random()));
+  process.exit(0);
+}
+
+assert.equal(seeder.internal.waitpid(pid), 0);
+const childDraw = JSON.parse(fs.readFileSync(file, 'utf8'));
+fs.unlinkSync(file);
+
+const stream0 = new seeder.PRNG();
+forking.select(stream0, 0);
+stream0.random();
+assert.equal(p.random(), stream0.random());
+
+const stream1 = new seeder.PRNG();
+forking.select(stream1, 1);
+assert.equal(childDraw, stream1.random());
+assert.equal(forking.claim(new seeder.PRNG()), 2);
+
+forking.unlink();
@@ -0,0 +1,73 @@
+// jshint esversion: 6
+
+var assert = require('assert');
+var child_process = require('child_process');
+var fs = require('fs');
+var os = require('os');
+var path = require('path');
+var v8 = require('v8');
+
+if (!v8.startupSnapshot) {
+  console.log('startup snapshots are not supported, skipped');
+  process.exit(0);
+}
+
+// Snapshot entry points can only require builtins, so pkg/seeder.js goes in
+// as a bundle would put it, and the addon is required at run time.
+const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'nreseed-snapshot-'));
+const seederPath = path.join(__dirname, '../pkg/seeder.js');
+const entry = path.join(dir, 'entry.js');
+const blob = path.join(dir, 'snapshot.blob');
+
+fs.writeFileSync(entry, `
+const seeder = (function() {
+  const module = { exports: {} };
+  (function(module, exports, require) {
+${fs.readFileSync(seederPath, 'utf8')}
+  })(module, module.exports, function(id) {
+    return id === 'bindings'
+      ? require('module').createRequire(${JSON.stringify(seederPath)})(id)
+      : require(id);
+  });
+  return module.exports;
+})();
+
+// Not reseeded (nor loaded) yet, the builtin serves the build.
+const builtin = Math.random;
+seeder.reseed();
+const placeholder = Math.random;
+Math.random();
+
+require('v8').startupSnapshot.setDeserializeMainFunction(() => {
+  const first = Math.random();
+  console.log(JSON.stringify({
+    placeholder: placeholder !== builtin,
+    random: [first, new seeder.PRNG().random()],
+    builtin: Math.random === builtin,
+    swapped: Math.random !== placeholder,
+    source: Math.random.toString(),
+  }));
+});
+`);
+
+child_process.execFileSync(process.execPath, ['--snapshot-blob', blob, '--build-snapshot', entry],
+                           { stdio: 'ignore' });
+
+// --- every process started from the snapshot gets its own randomness
+
+const run = () => JSON.parse(child_process.execFileSync(process.execPath, ['--snapshot-blob', blob]).toString());
+const a = run();
+const b = run();
+assert.notEqual(a.random[0], b.random[0]);
+assert.notEqual(a.random[1], b.random[1]);
+
+// --- the first call swaps the placeholder for the addon backed Math.random()
+
+for (const out of [a, b]) {
+  assert(out.placeholder);
+  assert(!out.builtin);
+  assert(out.swapped);
+  assert(out.source.includes('prng.random()'), out.source);
+}
+
+fs.rmSync(dir, { recursive: true });
@@ -0,0 +1,44 @@
+// jshint esversion: 6
+
+var seeder = require('../pkg/seeder');
+var assert = require('assert');
+
+// --- picks follow the weights
+
+const weights = new Float64Array([1, 0, 3, 6]);
+const s = new seeder.WeightedSampler(weights, 0);
+
+const out = new Uint32Array(100000);
+assert.equal(s.sampleInto(out), out);
+
+const counts = [0, 0, 0, 0];
+for (const i of out) {
+  counts[i]++;
+}
+
+console.log("WeightedSampler counts = " + counts);
+assert.equal(counts[1], 0);
+assert(Math.abs(counts[0] / out.length - 0.1) < 0.01);
+assert(Math.abs(counts[2] / out.length - 0.3) < 0.01);
+assert(Math.abs(counts[3] / out.length - 0.6) < 0.01);
+
+// --- same seed, same picks; shared PRNG works too
+
+const a = new seeder.WeightedSampler(weights, 1);
+const b = new seeder.WeightedSampler(weights, new seeder.PRNG(1));
+for (let i = 0; i < 100; i++) {
+  assert.equal(a.sample(), b.sample());
+}
+
+// --- updates are applied on the next sample
+
+s.update(0, 0);
+s.update(2, 0);
+s.update(3, 0);
+s.update(1, 1);
+assert.equal(s.sample(), 1);
+
+s.update(1, 0);
+assert.throws(() => s.sample(), RangeError);
+assert.throws(() => s.update(4, 1), RangeError);
+assert.throws(() => new seeder.WeightedSampler([1, 2]), TypeError);